@@ -39,6 +39,8 @@ typedef enum GameScreen { LOGO = 0, TITLE, OPTIONS, GAMEPLAY, ENDING } GameScree
 extern GameScreen currentScreen;
 extern Font font;
 extern Music music;
+extern float updateStep;        // Seconds per fixed update
+extern float drawAlpha;         // How far drawing is between the last two updates, 0 to 1
 
 #ifdef __cplusplus
 extern "C" {            // Prevents name mangling of functions
@@ -75,6 +77,7 @@ extern "C" {            // Prevents name mangling of functions
 	// Gameplay Screen Functions Declaration
 	//----------------------------------------------------------------------------------
 	void InitGameplayScreen(void);
+	const char** GetGameplayScreenImages(int* count);	// Images InitGameplayScreen() will load, for prefetch
 	void UpdateGameplayScreen(void);
 	void DrawGameplayScreen(void);
 	void UnloadGameplayScreen(void);
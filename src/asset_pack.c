@@ -0,0 +1,220 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Asset pack: all of data/ in a single file built by tools/packer.c, mapped once at startup.
+*
+*   Images and music are decoded straight from the mapping (LoadImagePacked, LoadMusicPacked).
+*   Everything else raylib opens by path goes through the LoadFileData callback. raylib frees
+*   what that callback returns, so those loads get a copy of the packed bytes, but still no
+*   open/stat/read per file.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "asset_pack.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PACK_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//---------------------------------------------------------------------------------
+static unsigned char* pack = NULL;
+static size_t packSize = 0;
+static const PackEntry* entries = NULL;
+static const unsigned int* slots = NULL;
+static PackHeader header = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+static unsigned char* LoadLooseFileData(const char* fileName, unsigned int* bytesRead)
+{
+    // Same as raylib's own loader, which the callback replaces
+    unsigned char* data = NULL;
+    *bytesRead = 0;
+
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to open file", fileName);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if (size > 0)
+    {
+        data = (unsigned char*)MemAlloc((int)size);
+        *bytesRead = (unsigned int)fread(data, 1, size, file);
+    }
+
+    fclose(file);
+    return data;
+}
+
+static unsigned char* LoadPackedFileData(const char* fileName, unsigned int* bytesRead)
+{
+    unsigned int size = 0;
+    const unsigned char* packed = GetPackedFile(fileName, &size);
+
+    if (packed == NULL) return LoadLooseFileData(fileName, bytesRead);
+
+    unsigned char* data = (unsigned char*)MemAlloc(size);
+    memcpy(data, packed, size);
+    *bytesRead = size;
+
+    return data;
+}
+
+static bool ValidatePack(void)
+{
+    if (packSize < sizeof(PackHeader)) return false;
+
+    memcpy(&header, pack, sizeof(PackHeader));
+    if (memcmp(header.magic, PACK_MAGIC, 4) != 0 || header.version != PACK_VERSION) return false;
+    if (header.slotCount == 0 || (header.slotCount & (header.slotCount - 1)) != 0) return false;
+
+    size_t directorySize = sizeof(PackHeader) + header.entryCount * sizeof(PackEntry) + header.slotCount * sizeof(unsigned int);
+    if (directorySize > packSize) return false;
+
+    entries = (const PackEntry*)(pack + sizeof(PackHeader));
+    slots = (const unsigned int*)(entries + header.entryCount);
+
+    // Names sit between the directory and the first file's data
+    size_t namesEnd = packSize;
+    for (unsigned int i = 0; i < header.entryCount; ++i)
+    {
+        if ((size_t)entries[i].dataOffset + entries[i].dataSize > packSize) return false;
+        if (entries[i].dataOffset < namesEnd) namesEnd = entries[i].dataOffset;
+    }
+
+    for (unsigned int i = 0; i < header.entryCount; ++i)
+    {
+        size_t nameOffset = entries[i].nameOffset;
+        if (nameOffset < directorySize || nameOffset >= namesEnd) return false;
+        if (memchr(pack + nameOffset, '\0', namesEnd - nameOffset) == NULL) return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Asset Pack Functions Definition
+//----------------------------------------------------------------------------------
+bool MountAssetPack(const char* fileName)
+{
+    UnmountAssetPack();
+
+#if defined(PACK_USE_MMAP)
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            pack = (unsigned char*)mapping;
+            packSize = (size_t)info.st_size;
+        }
+    }
+    close(fd);
+#else
+    // No mmap here, one read of the whole pack is still a single sequential I/O
+    unsigned int size = 0;
+    pack = LoadLooseFileData(fileName, &size);
+    packSize = size;
+#endif
+
+    if (pack == NULL) return false;
+
+    if (!ValidatePack())
+    {
+        TraceLog(LOG_WARNING, "PACK: [%s] Invalid asset pack, using loose files", fileName);
+        UnmountAssetPack();
+        return false;
+    }
+
+    SetLoadFileDataCallback(LoadPackedFileData);
+    TraceLog(LOG_INFO, "PACK: [%s] Mounted %u files (%u KB)", fileName, header.entryCount, (unsigned int)(packSize / 1024));
+
+    return true;
+}
+
+void UnmountAssetPack(void)
+{
+    if (pack == NULL) return;
+
+    SetLoadFileDataCallback(NULL);
+
+#if defined(PACK_USE_MMAP)
+    munmap(pack, packSize);
+#else
+    MemFree(pack);
+#endif
+
+    pack = NULL;
+    packSize = 0;
+    entries = NULL;
+    slots = NULL;
+    header = (PackHeader){ 0 };
+}
+
+const unsigned char* GetPackedFile(const char* fileName, unsigned int* dataSize)
+{
+    if (pack == NULL) return NULL;
+
+    unsigned int hash = HashPackPath(fileName);
+    unsigned int mask = header.slotCount - 1;
+
+    for (unsigned int i = 0; i < header.slotCount; ++i)
+    {
+        unsigned int slot = slots[(hash + i) & mask];
+        if (slot == 0) break;
+
+        const PackEntry* entry = &entries[slot - 1];
+        if (entry->hash == hash && strcmp((const char*)pack + entry->nameOffset, fileName) == 0)
+        {
+            *dataSize = entry->dataSize;
+            return pack + entry->dataOffset;
+        }
+    }
+
+    return NULL;
+}
+
+Image LoadImagePacked(const char* fileName)
+{
+    unsigned int size = 0;
+    const unsigned char* data = GetPackedFile(fileName, &size);
+
+    if (data == NULL) return LoadImage(fileName);
+
+    return LoadImageFromMemory(GetFileExtension(fileName), data, (int)size);
+}
+
+Music LoadMusicPacked(const char* fileName)
+{
+    unsigned int size = 0;
+    const unsigned char* data = GetPackedFile(fileName, &size);
+
+    if (data == NULL) return LoadMusicStream(fileName);
+
+    // NOTE: The mapping outlives the stream, raylib keeps reading from it while playing
+    return LoadMusicStreamFromMemory(GetFileExtension(fileName), (unsigned char*)data, (int)size);
+}
@@ -0,0 +1,60 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Pack layout, all values little endian:
+//   PackHeader
+//   PackEntry[entryCount]      - in first use order, data follows the same order
+//   unsigned int[slotCount]    - hashed directory, entry index + 1 (0 is empty), linear probing
+//   names                      - '\0' terminated paths, i.e. "data/bg.png"
+//   data                       - file contents, each aligned to PACK_DATA_ALIGNMENT
+#define PACK_MAGIC "LTPK"
+#define PACK_VERSION 1
+#define PACK_DATA_ALIGNMENT 16
+
+typedef struct PackHeader
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int entryCount;
+	unsigned int slotCount;		// Power of two, at least twice entryCount
+} PackHeader;
+
+typedef struct PackEntry
+{
+	unsigned int hash;
+	unsigned int nameOffset;	// From start of pack
+	unsigned int dataOffset;	// From start of pack
+	unsigned int dataSize;
+} PackEntry;
+
+// FNV-1a, shared by the packer and the runtime lookup
+static inline unsigned int HashPackPath(const char* path)
+{
+	unsigned int hash = 2166136261u;
+	for (; *path != '\0'; ++path) hash = (hash ^ (unsigned char)*path) * 16777619u;
+	return hash;
+}
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Asset Pack Functions Declaration
+	//----------------------------------------------------------------------------------
+	bool MountAssetPack(const char* fileName);	// Map pack and route raylib file loading through it
+	void UnmountAssetPack(void);
+	const unsigned char* GetPackedFile(const char* fileName, unsigned int* dataSize);	// Pointer into the mapping, NULL if not packed
+	Image LoadImagePacked(const char* fileName);	// Decode straight from the mapping, loose file fallback
+	Music LoadMusicPacked(const char* fileName);	// Stream straight from the mapping, loose file fallback
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_PACK_H
@@ -0,0 +1,246 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Asset prefetch: decodes the images of the next screen on a small pool of worker threads,
+*   at startup while the LOGO screen plays and later while a screen transition fades in.
+*   Only the GPU upload is left for the main thread, which picks the decoded images up
+*   through TakePrefetchedImage() when the texture cache misses.
+*
+*   Workers time reading and decoding separately, see GetPrefetchStats().
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "asset_prefetch.h"
+#include "asset_pack.h"
+#include "texture_cache.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if !defined(PLATFORM_WEB)
+#include <stdatomic.h>
+#include <threads.h>
+#endif
+
+#define MAX_PREFETCH_PATH 128
+#define PREFETCH_PAGE_SIZE 4096
+
+typedef struct PrefetchSlot
+{
+    char fileName[MAX_PREFETCH_PATH];
+    Image image;
+    double ioSeconds;
+    double decodeSeconds;
+#if !defined(PLATFORM_WEB)
+    atomic_bool ready;          // Set by a worker once image is decoded
+#else
+    bool ready;
+#endif
+} PrefetchSlot;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//---------------------------------------------------------------------------------
+static PrefetchSlot slots[MAX_PREFETCH_IMAGES] = { 0 };
+static int slotCount = 0;
+static PrefetchStats stats = { 0 };
+
+#if !defined(PLATFORM_WEB)
+static thrd_t workers[PREFETCH_WORKERS];
+static double workerDone[PREFETCH_WORKERS] = { 0 };
+static int workerCount = 0;
+static int batchStart = 0;              // First slot queued by the running batch
+static double batchStartTime = 0.0;
+static atomic_int nextSlot = 0;         // Next slot a worker claims
+static atomic_int activeWorkers = 0;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+#if !defined(PLATFORM_WEB)
+// Fault the pages of a packed file in, otherwise disk reads are billed to the decoder
+static void TouchPages(const unsigned char* data, unsigned int size)
+{
+    volatile unsigned char sink = 0;
+    for (unsigned int i = 0; i < size; i += PREFETCH_PAGE_SIZE) sink ^= data[i];
+    (void)sink;
+}
+
+static void DecodeSlot(PrefetchSlot* slot)
+{
+    double start = GetTime();
+
+    unsigned int size = 0;
+    unsigned char* looseData = NULL;
+    const unsigned char* data = GetPackedFile(slot->fileName, &size);
+
+    if (data != NULL) TouchPages(data, size);
+    else data = looseData = LoadFileData(slot->fileName, &size);
+
+    double read = GetTime();
+
+    if (data != NULL) slot->image = LoadImageFromMemory(GetFileExtension(slot->fileName), data, (int)size);
+    if (looseData != NULL) UnloadFileData(looseData);
+
+    slot->ioSeconds = read - start;
+    slot->decodeSeconds = GetTime() - read;
+}
+
+static int PrefetchWorker(void* arg)
+{
+    int worker = (int)(intptr_t)arg;
+    int index = 0;
+
+    while ((index = atomic_fetch_add(&nextSlot, 1)) < slotCount)
+    {
+        DecodeSlot(&slots[index]);
+        atomic_store_explicit(&slots[index].ready, true, memory_order_release);
+    }
+
+    workerDone[worker] = GetTime();
+    atomic_fetch_sub_explicit(&activeWorkers, 1, memory_order_release);
+    return 0;
+}
+
+// Wait for the running batch and add its timings to the stats
+static void JoinWorkers(void)
+{
+    if (workerCount == 0) return;
+
+    double batchDone = batchStartTime;
+    for (int i = 0; i < workerCount; ++i)
+    {
+        thrd_join(workers[i], NULL);
+        if (workerDone[i] > batchDone) batchDone = workerDone[i];
+    }
+
+    for (int i = batchStart; i < slotCount; ++i)
+    {
+        stats.images += 1;
+        stats.ioSeconds += slots[i].ioSeconds;
+        stats.decodeSeconds += slots[i].decodeSeconds;
+    }
+
+    stats.wallSeconds += batchDone - batchStartTime;
+    if (workerCount > stats.workers) stats.workers = workerCount;
+
+    workerCount = 0;
+    batchStart = slotCount;
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Asset Prefetch Functions Definition
+//----------------------------------------------------------------------------------
+void PrefetchImages(const char** fileNames, int count)
+{
+#if !defined(PLATFORM_WEB)
+    // NOTE: Images of an earlier batch nobody took yet are kept, so a screen can use what
+    // startup decoded. Its workers are joined first, which only blocks if it is still running.
+    JoinWorkers();
+
+    for (int i = 0; i < count && slotCount < MAX_PREFETCH_IMAGES; ++i)
+    {
+        // Atlased sprites share one image (decode it once), variants replace the full size image
+        const char* fileName = ResolveImageFile(fileNames[i]);
+        bool queued = false;
+        for (int j = 0; j < slotCount; ++j) queued |= (strcmp(slots[j].fileName, fileName) == 0);
+        if (queued) continue;
+
+        strncpy(slots[slotCount].fileName, fileName, MAX_PREFETCH_PATH - 1);
+        slots[slotCount].image = (Image){ 0 };
+        slots[slotCount].ioSeconds = 0.0;
+        slots[slotCount].decodeSeconds = 0.0;
+        atomic_store(&slots[slotCount].ready, false);
+        slotCount += 1;
+    }
+
+    int pending = slotCount - batchStart;
+    if (pending == 0) return;
+
+    int wanted = (pending < PREFETCH_WORKERS) ? pending : PREFETCH_WORKERS;
+    atomic_store(&nextSlot, batchStart);
+    atomic_store(&activeWorkers, wanted);
+    batchStartTime = GetTime();
+
+    while (workerCount < wanted)
+    {
+        if (thrd_create(&workers[workerCount], PrefetchWorker, (void*)(intptr_t)workerCount) != thrd_success) break;
+        workerCount += 1;
+    }
+
+    if (workerCount < wanted)
+    {
+        TraceLog(LOG_WARNING, "PREFETCH: Started %i of %i worker threads", workerCount, wanted);
+        atomic_fetch_sub(&activeWorkers, wanted - workerCount);
+
+        // No worker at all, scenes simply load from disk as before
+        if (workerCount == 0) slotCount = batchStart;
+    }
+#else
+    // No threads on web, screens load synchronously in Init
+    (void)fileNames;
+    (void)count;
+#endif
+}
+
+bool IsPrefetchPending(void)
+{
+#if !defined(PLATFORM_WEB)
+    return atomic_load_explicit(&activeWorkers, memory_order_acquire) > 0;
+#else
+    return false;
+#endif
+}
+
+// Block until the running batch is decoded, its images stay queued for the screen
+void WaitForPrefetch(void)
+{
+#if !defined(PLATFORM_WEB)
+    JoinWorkers();
+#endif
+}
+
+bool TakePrefetchedImage(const char* fileName, Image* image)
+{
+    for (int i = 0; i < slotCount; ++i)
+    {
+        if (!slots[i].ready || slots[i].image.data == NULL) continue;
+
+        if (strcmp(slots[i].fileName, fileName) == 0)
+        {
+            *image = slots[i].image;
+            slots[i].image = (Image){ 0 };
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void UnloadPrefetchedImages(void)
+{
+#if !defined(PLATFORM_WEB)
+    JoinWorkers();
+    batchStart = 0;
+#endif
+
+    for (int i = 0; i < slotCount; ++i)
+    {
+        if (slots[i].image.data != NULL) UnloadImage(slots[i].image);
+        slots[i].image = (Image){ 0 };
+        slots[i].ready = false;
+    }
+
+    slotCount = 0;
+}
+
+PrefetchStats GetPrefetchStats(void)
+{
+    return stats;
+}
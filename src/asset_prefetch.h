@@ -0,0 +1,39 @@
+#ifndef ASSET_PREFETCH_H
+#define ASSET_PREFETCH_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define MAX_PREFETCH_IMAGES 32
+#define PREFETCH_WORKERS 4
+
+typedef struct PrefetchStats
+{
+	int images;				// Decoded by the workers since startup
+	int workers;			// Largest pool started so far
+	double ioSeconds;		// Reading file data, summed over workers
+	double decodeSeconds;	// Decoding to pixels, summed over workers
+	double wallSeconds;		// First worker start to last worker done, summed over batches
+} PrefetchStats;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Asset Prefetch Functions Declaration
+	//----------------------------------------------------------------------------------
+	void PrefetchImages(const char** fileNames, int count);	// Start decoding images on the worker pool, adds to queued ones
+	bool IsPrefetchPending(void);							// Check if any worker is still decoding
+	void WaitForPrefetch(void);								// Block until the workers are done
+	bool TakePrefetchedImage(const char* fileName, Image* image);	// Take ownership of a decoded image, if any
+	void UnloadPrefetchedImages(void);						// Wait for the workers and free images nobody took
+	PrefetchStats GetPrefetchStats(void);					// Batches count once their workers are joined
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_PREFETCH_H
@@ -0,0 +1,186 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Audio: music decoding and stream refill on a dedicated thread, so a scene load or any
+*   long frame on the main thread no longer starves the stream.
+*
+*   raylib 4.0 has no audio stream callback to feed PCM from, so the player thread owns the
+*   Music outright and runs UpdateMusicStream() at its own pace. The main thread never touches
+*   the Music again, it sends commands through a lock-free single producer/single consumer
+*   ring instead.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "audio.h"
+
+#include <stddef.h>
+
+#if !defined(PLATFORM_WEB)
+#include <stdatomic.h>
+#include <threads.h>
+#include <time.h>
+#endif
+
+typedef enum MusicCommandType { MUSIC_PLAY = 0, MUSIC_STOP, MUSIC_VOLUME } MusicCommandType;
+
+typedef struct MusicCommand
+{
+    MusicCommandType type;
+    float value;
+} MusicCommand;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//---------------------------------------------------------------------------------
+static Music playerMusic = { 0 };
+static double bufferSeconds = 0.0;      // Sub-buffer length, longer gaps between refills underrun
+static double lastUpdate = 0.0;
+
+#if !defined(PLATFORM_WEB)
+static thrd_t playerThread;
+static atomic_bool playerRunning = false;
+static atomic_int underruns = 0;
+
+// Ring: main thread only writes head, player thread only writes tail
+static MusicCommand commands[MUSIC_COMMAND_QUEUE];
+static atomic_uint commandHead = 0;
+static atomic_uint commandTail = 0;
+#else
+static int underruns = 0;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+static void RunCommand(MusicCommand command)
+{
+    switch (command.type)
+    {
+    case MUSIC_PLAY: PlayMusicStream(playerMusic); break;
+    case MUSIC_STOP: StopMusicStream(playerMusic); break;
+    case MUSIC_VOLUME: SetMusicVolume(playerMusic, command.value); break;
+    default: break;
+    }
+}
+
+static void RefillMusic(void)
+{
+    double now = GetTime();
+
+    if (IsMusicStreamPlaying(playerMusic) && lastUpdate > 0.0 && now - lastUpdate > bufferSeconds) underruns += 1;
+    lastUpdate = now;
+
+    UpdateMusicStream(playerMusic);
+}
+
+#if !defined(PLATFORM_WEB)
+static int MusicPlayerThread(void* arg)
+{
+    (void)arg;
+
+    // Poll a few times per sub-buffer, refilling is cheap when nothing was consumed
+    long sleepNanoseconds = (long)(bufferSeconds * 1e9 / 4.0);
+    struct timespec sleep = { 0, sleepNanoseconds };
+
+    while (atomic_load_explicit(&playerRunning, memory_order_acquire))
+    {
+        unsigned int tail = atomic_load_explicit(&commandTail, memory_order_relaxed);
+        while (tail != atomic_load_explicit(&commandHead, memory_order_acquire))
+        {
+            RunCommand(commands[tail & (MUSIC_COMMAND_QUEUE - 1)]);
+            tail += 1;
+            atomic_store_explicit(&commandTail, tail, memory_order_release);
+        }
+
+        RefillMusic();
+        thrd_sleep(&sleep, NULL);
+    }
+
+    return 0;
+}
+#endif
+
+static void SendCommand(MusicCommand command)
+{
+#if !defined(PLATFORM_WEB)
+    if (atomic_load(&playerRunning))
+    {
+        unsigned int head = atomic_load_explicit(&commandHead, memory_order_relaxed);
+
+        // Full ring means the player thread is stuck, dropping a command beats blocking the game
+        if (head - atomic_load_explicit(&commandTail, memory_order_acquire) == MUSIC_COMMAND_QUEUE) return;
+
+        commands[head & (MUSIC_COMMAND_QUEUE - 1)] = command;
+        atomic_store_explicit(&commandHead, head + 1, memory_order_release);
+        return;
+    }
+#endif
+
+    RunCommand(command);
+}
+
+//----------------------------------------------------------------------------------
+// Audio Functions Definition
+//----------------------------------------------------------------------------------
+void StartMusicPlayer(Music music)
+{
+    playerMusic = music;
+    bufferSeconds = (double)MUSIC_BUFFER_FRAMES / (music.stream.sampleRate > 0 ? music.stream.sampleRate : 44100);
+    lastUpdate = 0.0;
+    underruns = 0;
+
+#if !defined(PLATFORM_WEB)
+    atomic_store(&commandHead, 0);
+    atomic_store(&commandTail, 0);
+    atomic_store(&playerRunning, true);
+
+    if (thrd_create(&playerThread, MusicPlayerThread, NULL) != thrd_success)
+    {
+        TraceLog(LOG_WARNING, "AUDIO: Failed to start music thread, refilling from the main loop");
+        atomic_store(&playerRunning, false);
+    }
+#endif
+}
+
+void StopMusicPlayer(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (atomic_exchange(&playerRunning, false)) thrd_join(playerThread, NULL);
+#endif
+
+    TraceLog(LOG_INFO, "AUDIO: Music stopped after %i underruns", GetMusicUnderruns());
+    playerMusic = (Music){ 0 };
+}
+
+void UpdateMusicPlayer(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (atomic_load(&playerRunning)) return;
+#endif
+
+    if (playerMusic.ctxData != NULL) RefillMusic();
+}
+
+void PlayMusic(void)
+{
+    SendCommand((MusicCommand){ MUSIC_PLAY, 0.0f });
+}
+
+void StopMusic(void)
+{
+    SendCommand((MusicCommand){ MUSIC_STOP, 0.0f });
+}
+
+void SetMusicPlayerVolume(float volume)
+{
+    SendCommand((MusicCommand){ MUSIC_VOLUME, volume });
+}
+
+int GetMusicUnderruns(void)
+{
+    return underruns;
+}
@@ -0,0 +1,31 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define MUSIC_BUFFER_FRAMES 4096		// Per stream sub-buffer, set before loading music
+#define MUSIC_COMMAND_QUEUE 16			// Power of two
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Audio Functions Declaration
+	//----------------------------------------------------------------------------------
+	void StartMusicPlayer(Music music);		// Music belongs to the player thread from here on
+	void StopMusicPlayer(void);				// Join the thread, music can be unloaded after this
+	void UpdateMusicPlayer(void);			// Only does work when there is no player thread (web)
+	void PlayMusic(void);
+	void StopMusic(void);
+	void SetMusicPlayerVolume(float volume);
+	int GetMusicUnderruns(void);			// Refills that came too late, the stream ran dry
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_H
@@ -0,0 +1,151 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Background: scene layer stacks. None of the current layers move, so instead of blending
+*   six or seven full screen layers every frame they are flattened once into a render
+*   texture when the scene loads and the layer textures are released. Layers flagged as
+*   animated or parallax (and anything above them, to keep the order) stay separate.
+*
+*   Scenes can be wider than the window, so the flattened layers are split into columns and
+*   only the columns the camera shows are submitted.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "background.h"
+#include "texture_cache.h"
+#include "render.h"
+#include "draw_recorder.h"
+
+#include <math.h>
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+// Scene area a layer covers, the same rectangle SubmitLayer() draws to
+static Rectangle LayerBounds(const BackgroundLayer* layer, TextureHandle texture)
+{
+    Texture2D art = UseTexture(texture);
+    float scale = layer->scale / GetTextureScale(texture);
+    return (Rectangle){ layer->position.x, layer->position.y, art.width * scale, art.height * scale };
+}
+
+static Rectangle TileBounds(const Background* background, int tile)
+{
+    Texture2D texture = background->tiles[tile].texture;
+    return (Rectangle){ (float)(tile * BACKGROUND_TILE_WIDTH), 0, (float)texture.width, (float)texture.height };
+}
+
+//----------------------------------------------------------------------------------
+// Background Functions Definition
+//----------------------------------------------------------------------------------
+void LoadBackground(Background* background, const BackgroundLayer* layers, int count)
+{
+    *background = (Background){ 0 };
+
+    // NOTE: Only UpdateTextureCache() evicts, acquiring these again below does not reload them
+    for (int i = 0; i < count; ++i)
+    {
+        TextureHandle texture = AcquireTexture(layers[i].fileName);
+        Rectangle bounds = LayerBounds(&layers[i], texture);
+        background->size.x = fmaxf(background->size.x, bounds.x + bounds.width);
+        background->size.y = fmaxf(background->size.y, bounds.y + bounds.height);
+        ReleaseTexture(texture);
+    }
+
+    int first = 0;
+
+#if COMPOSITE_STATIC_LAYERS
+    while (first < count && layers[first].flags == LAYER_STATIC) first += 1;
+
+    if (first > 0)
+    {
+        int width = (int)ceilf(background->size.x);
+        int height = (int)ceilf(background->size.y);
+
+        background->tileCount = (width + BACKGROUND_TILE_WIDTH - 1) / BACKGROUND_TILE_WIDTH;
+        if (background->tileCount > MAX_BACKGROUND_TILES)
+        {
+            TraceLog(LOG_WARNING, "BACKGROUND: Scene is %i pixels wide, only the first %i are drawn", width, MAX_BACKGROUND_TILES * BACKGROUND_TILE_WIDTH);
+            background->tileCount = MAX_BACKGROUND_TILES;
+        }
+
+        for (int t = 0; t < background->tileCount; ++t)
+        {
+            int tileWidth = width - t * BACKGROUND_TILE_WIDTH;
+            if (tileWidth > BACKGROUND_TILE_WIDTH) tileWidth = BACKGROUND_TILE_WIDTH;
+
+            background->tiles[t] = LoadRenderTexture(tileWidth, height);
+            BeginTextureMode(background->tiles[t]);
+            ClearBackground(RAYWHITE);      // Same clear color the screen uses
+            EndTextureMode();
+        }
+
+        for (int i = 0; i < first; ++i)
+        {
+            // NOTE: Released textures are never evicted in the frame they were drawn in
+            TextureHandle texture = AcquireTexture(layers[i].fileName);
+            Rectangle bounds = LayerBounds(&layers[i], texture);
+
+            for (int t = 0; t < background->tileCount; ++t)
+            {
+                Rectangle tile = TileBounds(background, t);
+                if (!CheckCollisionRecs(bounds, tile)) continue;
+
+                BeginTextureMode(background->tiles[t]);
+                DrawTextureEx(UseTexture(texture), (Vector2){ bounds.x - tile.x, bounds.y - tile.y }, 0.0f, layers[i].scale / GetTextureScale(texture), WHITE);
+                EndTextureMode();
+            }
+            ReleaseTexture(texture);
+        }
+
+        // Tiles are drawn with alpha blending again, they have to stay opaque
+        for (int t = 0; t < background->tileCount; ++t)
+        {
+            Texture2D texture = background->tiles[t].texture;
+
+            BeginTextureMode(background->tiles[t]);
+            RestoreTargetAlpha((Rectangle){ 0, 0, (float)texture.width, (float)texture.height });
+            EndTextureMode();
+        }
+    }
+#endif
+
+    for (int i = first; i < count && background->layerCount < MAX_BACKGROUND_LAYERS; ++i)
+    {
+        background->layers[background->layerCount] = layers[i];
+        background->textures[background->layerCount] = AcquireTexture(layers[i].fileName);
+        background->bounds[background->layerCount] = LayerBounds(&layers[i], background->textures[background->layerCount]);
+        background->layerCount += 1;
+    }
+}
+
+void DrawBackground(Background* background)
+{
+    for (int t = 0; t < background->tileCount; ++t)
+    {
+        Rectangle tile = TileBounds(background, t);
+        if (IsInRenderView(tile)) SubmitRenderTarget(RENDER_BACKGROUND, background->tiles[t], tile, WHITE);
+    }
+
+    for (int i = 0; i < background->layerCount; ++i)
+    {
+        if (!IsInRenderView(background->bounds[i])) continue;
+        SubmitLayer(RENDER_BACKGROUND, background->textures[i], background->layers[i].position, background->layers[i].scale, WHITE);
+    }
+}
+
+void UnloadBackground(Background* background)
+{
+    for (int t = 0; t < background->tileCount; ++t) UnloadRenderTexture(background->tiles[t]);
+
+    for (int i = 0; i < background->layerCount; ++i)
+    {
+        ReleaseTexture(background->textures[i]);
+    }
+
+    *background = (Background){ 0 };
+}
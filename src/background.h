@@ -0,0 +1,60 @@
+#ifndef BACKGROUND_H
+#define BACKGROUND_H
+
+#include "raylib.h"
+#include "texture_cache.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define MAX_BACKGROUND_LAYERS 8
+#define MAX_BACKGROUND_TILES 16
+#define BACKGROUND_TILE_WIDTH 512		// Static layers are flattened into columns this wide, culled one by one
+
+// Set to 0 to draw every layer every frame, for comparison
+#if !defined(COMPOSITE_STATIC_LAYERS)
+#define COMPOSITE_STATIC_LAYERS 1
+#endif
+
+typedef enum LayerFlags
+{
+	LAYER_STATIC = 0,
+	LAYER_ANIMATED = 1,			// Changes over time, drawn on its own every frame
+	LAYER_PARALLAX = 2			// Scrolls with the view, drawn on its own every frame
+} LayerFlags;
+
+typedef struct BackgroundLayer
+{
+	const char* fileName;
+	Vector2 position;
+	float scale;
+	int flags;
+} BackgroundLayer;
+
+typedef struct Background
+{
+	Vector2 size;				// Extent of every layer from the scene origin, the camera stays inside it
+	int tileCount;				// Static layers below the first animated one, flattened at load
+	RenderTexture2D tiles[MAX_BACKGROUND_TILES];
+	int layerCount;				// Layers still drawn one by one, on top of the tiles
+	BackgroundLayer layers[MAX_BACKGROUND_LAYERS];
+	TextureHandle textures[MAX_BACKGROUND_LAYERS];
+	Rectangle bounds[MAX_BACKGROUND_LAYERS];	// Where each of those lands, for culling
+} Background;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Background Functions Declaration
+	//----------------------------------------------------------------------------------
+	void LoadBackground(Background* background, const BackgroundLayer* layers, int count);
+	void DrawBackground(Background* background);		// Submits what is in view to RENDER_BACKGROUND, see render.h
+	void UnloadBackground(Background* background);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BACKGROUND_H
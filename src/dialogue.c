@@ -0,0 +1,241 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Dialogue: trees are written as text and compiled by tools/dialogue_compiler.c, see the
+*   layout in dialogue.h. Nodes refer to each other by index and strings by offset, so walking
+*   a graph is array reads with no parsing or allocation however many lines an NPC has. The
+*   few answers of a node are measured with the loaded game font on entering it. A loaded file
+*   is checked once here, the walk below trusts every index in it.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "dialogue.h"
+#include "asset_pack.h"
+#include "text.h"
+
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+static bool IsConditionMet(unsigned int flags, unsigned int required, unsigned int excluded)
+{
+    return ((flags & required) == required) && ((flags & excluded) == 0);
+}
+
+static bool IsTargetValid(const DialogueHeader* header, unsigned int target)
+{
+    return (target == DIALOGUE_END) || (target < header->nodeCount);
+}
+
+// Every offset, index and count in range, strings terminated
+static bool IsGraphValid(const DialogueGraph* graph)
+{
+    const DialogueHeader* header = graph->header;
+    const char* strings = graph->strings;
+
+    for (unsigned int i = 0; i < header->nodeCount; ++i)
+    {
+        const DialogueNode* node = &graph->nodes[i];
+        if ((node->name >= header->stringsSize) || (node->text >= header->stringsSize)) return false;
+        if ((node->firstBranch > header->branchCount) || (node->branchCount > header->branchCount - node->firstBranch)) return false;
+        if ((node->firstAnswer > header->answerCount) || (node->answerCount > header->answerCount - node->firstAnswer)) return false;
+    }
+
+    for (unsigned int i = 0; i < header->branchCount; ++i)
+    {
+        if (!IsTargetValid(header, graph->branches[i].target)) return false;
+    }
+
+    for (unsigned int i = 0; i < header->answerCount; ++i)
+    {
+        if (!IsTargetValid(header, graph->answers[i].target) || (graph->answers[i].text >= header->stringsSize)) return false;
+    }
+
+    // Lookups probe until an empty slot, a full table would never end one for a missing name
+    unsigned int emptySlots = 0;
+    for (unsigned int i = 0; i < header->slotCount; ++i)
+    {
+        if (graph->slots[i] > header->nodeCount) return false;
+        if (graph->slots[i] == 0) emptySlots += 1;
+    }
+
+    if (emptySlots == 0) return false;
+
+    for (unsigned int i = 0; i < header->flagCount; ++i)
+    {
+        if (graph->flagNames[i] >= header->stringsSize) return false;
+    }
+
+    return (header->stringsSize > 0) && (strings[header->stringsSize - 1] == '\0');
+}
+
+// Follows branches from node, then lays out the answers of the node it stays in
+static bool EnterDialogueNode(Dialogue* dialogue, unsigned int node)
+{
+    const DialogueGraph* graph = dialogue->graph;
+
+    for (int jumps = 0; (node != DIALOGUE_END) && (jumps < MAX_DIALOGUE_JUMPS); ++jumps)
+    {
+        const DialogueNode* entered = &graph->nodes[node];
+        unsigned int next = node;
+        for (unsigned int i = 0; i < entered->branchCount; ++i)
+        {
+            const DialogueBranch* branch = &graph->branches[entered->firstBranch + i];
+            if (IsConditionMet(dialogue->flags, branch->required, branch->excluded))
+            {
+                next = branch->target;
+                break;
+            }
+        }
+
+        if (next == node) break;
+        node = next;
+    }
+
+    dialogue->node = node;
+    dialogue->total_answers = 0;
+    if (node == DIALOGUE_END) return false;
+
+    const DialogueNode* current = &graph->nodes[node];
+    dialogue->flags = (dialogue->flags | current->setFlags) & ~current->clearFlags;
+    dialogue->spoken_dialogue = graph->strings + current->text;
+
+    float y = dialogue->origin.y;
+    for (unsigned int i = 0; (i < current->answerCount) && (dialogue->total_answers < MAX_DIALOGUE_ANSWERS); ++i)
+    {
+        const DialogueAnswer* answer = &graph->answers[current->firstAnswer + i];
+        if (!IsConditionMet(dialogue->flags, answer->required, answer->excluded)) continue;
+
+        // Measured now, the SDF font and the bitmap fallback lay the same text out differently
+        int shown = dialogue->total_answers;
+        const char* text = graph->strings + answer->text;
+        float width = MeasureGameText(text, dialogue->fontSize, dialogue->spacing).x;
+        dialogue->answer_dialogue_options[shown] = text;
+        dialogue->dialogue_location[shown] = (Rectangle){ dialogue->origin.x, y, width, dialogue->fontSize };
+        dialogue->answer_targets[shown] = answer->target;
+        dialogue->total_answers += 1;
+
+        y += dialogue->fontSize + DIALOGUE_ANSWER_GAP;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Dialogue Functions Definition
+//----------------------------------------------------------------------------------
+bool LoadDialogueGraph(DialogueGraph* graph, const char* fileName)
+{
+    *graph = (DialogueGraph){ 0 };
+
+    unsigned int size = 0;
+    const unsigned char* data = GetPackedFile(fileName, &size);
+    bool owned = (data == NULL);
+    if (owned) data = LoadFileData(fileName, &size);
+    if (data == NULL) return false;
+
+    const DialogueHeader* header = (const DialogueHeader*)data;
+    bool valid = (size >= sizeof(DialogueHeader)) && (memcmp(header->magic, DIALOGUE_MAGIC, 4) == 0) &&
+        (header->version == DIALOGUE_VERSION) && (header->flagCount <= MAX_DIALOGUE_FLAGS);
+
+    // NOTE: Counts widened before multiplying, a corrupt header must not wrap the sum
+    unsigned long long expected = sizeof(DialogueHeader);
+    if (valid)
+    {
+        expected += (unsigned long long)header->nodeCount * sizeof(DialogueNode);
+        expected += (unsigned long long)header->branchCount * sizeof(DialogueBranch);
+        expected += (unsigned long long)header->answerCount * sizeof(DialogueAnswer);
+        expected += ((unsigned long long)header->slotCount + header->flagCount) * sizeof(unsigned int);
+        expected += header->stringsSize;
+        valid = (expected == size) && (header->nodeCount > 0) &&
+            ((unsigned long long)header->slotCount >= 2ull * header->nodeCount) &&
+            ((header->slotCount & (header->slotCount - 1)) == 0);
+    }
+
+    if (valid)
+    {
+        graph->data = data;
+        graph->owned = owned;
+        graph->header = header;
+        graph->nodes = (const DialogueNode*)(data + sizeof(DialogueHeader));
+        graph->branches = (const DialogueBranch*)(graph->nodes + header->nodeCount);
+        graph->answers = (const DialogueAnswer*)(graph->branches + header->branchCount);
+        graph->slots = (const unsigned int*)(graph->answers + header->answerCount);
+        graph->flagNames = graph->slots + header->slotCount;
+        graph->strings = (const char*)(graph->flagNames + header->flagCount);
+        valid = IsGraphValid(graph);
+    }
+
+    if (!valid)
+    {
+        TraceLog(LOG_WARNING, "DIALOGUE: [%s] Not a dialogue graph of version %i", fileName, DIALOGUE_VERSION);
+        if (owned) UnloadFileData((unsigned char*)data);
+        *graph = (DialogueGraph){ 0 };
+        return false;
+    }
+
+    // Every line the NPC can say is known now, an SDF atlas gets its glyphs in one rebuild
+    PreloadGameText(graph->strings, (int)header->stringsSize);
+
+    TraceLog(LOG_INFO, "DIALOGUE: [%s] %i nodes, %i answers, %i bytes of strings", fileName,
+        header->nodeCount, header->answerCount, header->stringsSize);
+    return true;
+}
+
+void UnloadDialogueGraph(DialogueGraph* graph)
+{
+    if (graph->owned) UnloadFileData((unsigned char*)graph->data);
+    *graph = (DialogueGraph){ 0 };
+}
+
+int FindDialogueNode(const DialogueGraph* graph, const char* name)
+{
+    if (graph->header == NULL) return -1;
+
+    unsigned int hash = HashPackPath(name);
+    unsigned int mask = graph->header->slotCount - 1;
+
+    for (unsigned int slot = hash & mask; graph->slots[slot] != 0; slot = (slot + 1) & mask)
+    {
+        const DialogueNode* node = &graph->nodes[graph->slots[slot] - 1];
+        if ((node->hash == hash) && (strcmp(graph->strings + node->name, name) == 0)) return (int)(graph->slots[slot] - 1);
+    }
+
+    return -1;
+}
+
+int FindDialogueFlag(const DialogueGraph* graph, const char* name)
+{
+    if (graph->header == NULL) return -1;
+
+    for (unsigned int i = 0; i < graph->header->flagCount; ++i)
+    {
+        if (strcmp(graph->strings + graph->flagNames[i], name) == 0) return (int)i;
+    }
+
+    return -1;
+}
+
+// Needs graph, origin, fontSize and spacing set, flags are kept from the last talk
+bool StartDialogue(Dialogue* dialogue, int node)
+{
+    dialogue->node = DIALOGUE_END;
+    dialogue->total_answers = 0;
+
+    if ((dialogue->graph == NULL) || (dialogue->graph->header == NULL)) return false;
+    if ((node < 0) || ((unsigned int)node >= dialogue->graph->header->nodeCount)) return false;
+
+    return EnterDialogueNode(dialogue, (unsigned int)node);
+}
+
+bool ChooseDialogueAnswer(Dialogue* dialogue, int answer)
+{
+    if ((dialogue->node == DIALOGUE_END) || (answer < 0) || (answer >= dialogue->total_answers)) return false;
+
+    return EnterDialogueNode(dialogue, dialogue->answer_targets[answer]);
+}
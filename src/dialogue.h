@@ -0,0 +1,118 @@
+#ifndef DIALOGUE_H
+#define DIALOGUE_H
+
+#include "raylib.h"
+#include "asset_pack.h"					// HashPackPath() hashes node names as well
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Compiled dialogue layout, written by tools/dialogue_compiler.c, all values little endian:
+//   DialogueHeader
+//   DialogueNode[nodeCount]        - node 0 is where talking starts
+//   DialogueBranch[branchCount]    - each node's are consecutive, tried in order on entering it
+//   DialogueAnswer[answerCount]    - each node's are consecutive, in the order they show
+//   unsigned int[slotCount]        - hashed node names, node index + 1 (0 is empty), linear probing
+//   unsigned int[flagCount]        - name of each flag, bit i of the flags is flag i
+//   strings                        - interned, '\0' terminated, referred to by offset from here
+#define DIALOGUE_MAGIC "LTDG"
+#define DIALOGUE_VERSION 2
+#define DIALOGUE_END 0xffffffffu		// Target of a branch or answer that ends the talk
+#define MAX_DIALOGUE_ANSWERS 4			// Shown at once, after conditions
+#define MAX_DIALOGUE_FLAGS 32
+#define MAX_DIALOGUE_JUMPS 16			// Branches followed on one answer, stops a cycle of flags
+#define DIALOGUE_ANSWER_GAP 5			// Pixels between answer lines
+
+typedef struct DialogueHeader
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int nodeCount;
+	unsigned int branchCount;
+	unsigned int answerCount;
+	unsigned int slotCount;		// Power of two, at least twice nodeCount
+	unsigned int flagCount;
+	unsigned int stringsSize;
+} DialogueHeader;
+
+typedef struct DialogueNode
+{
+	unsigned int hash;			// Of the name, see HashPackPath()
+	unsigned int name;
+	unsigned int text;			// What the NPC says, empty for a node that only branches
+	unsigned int setFlags;		// Applied when no branch was taken and the node shows
+	unsigned int clearFlags;
+	unsigned int firstBranch;
+	unsigned int branchCount;
+	unsigned int firstAnswer;
+	unsigned int answerCount;
+} DialogueNode;
+
+// Taken when every required flag is set and every excluded one is clear
+typedef struct DialogueBranch
+{
+	unsigned int required;
+	unsigned int excluded;
+	unsigned int target;		// Node index or DIALOGUE_END
+} DialogueBranch;
+
+typedef struct DialogueAnswer
+{
+	unsigned int required;		// Shown under the same rule as a branch is taken
+	unsigned int excluded;
+	unsigned int target;
+	unsigned int text;
+} DialogueAnswer;
+
+// One compiled file, read only once loaded so NPCs can share it
+typedef struct DialogueGraph
+{
+	const unsigned char* data;
+	bool owned;					// Loaded from a loose file, the pack mapping otherwise
+	const DialogueHeader* header;
+	const DialogueNode* nodes;
+	const DialogueBranch* branches;
+	const DialogueAnswer* answers;
+	const unsigned int* slots;
+	const unsigned int* flagNames;
+	const char* strings;
+} DialogueGraph;
+
+// Walk through one graph, what the dialogue panel shows. Flags persist between talks.
+typedef struct Dialogue
+{
+	const DialogueGraph* graph;
+	unsigned int node;			// DIALOGUE_END when nothing is being said
+	unsigned int flags;
+	Vector2 origin;				// Top left of the first answer
+	float fontSize;
+	float spacing;
+
+	// Current node, laid out on entering it
+	const char* spoken_dialogue;
+	int total_answers;
+	const char* answer_dialogue_options[MAX_DIALOGUE_ANSWERS];
+	Rectangle dialogue_location[MAX_DIALOGUE_ANSWERS];
+	unsigned int answer_targets[MAX_DIALOGUE_ANSWERS];
+} Dialogue;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Dialogue Functions Declaration
+	//----------------------------------------------------------------------------------
+	bool LoadDialogueGraph(DialogueGraph* graph, const char* fileName);	// Straight from the pack mapping when packed
+	void UnloadDialogueGraph(DialogueGraph* graph);
+	int FindDialogueNode(const DialogueGraph* graph, const char* name);	// Node index, -1 if none
+	int FindDialogueFlag(const DialogueGraph* graph, const char* name);	// Bit of the flag, -1 if none
+
+	bool StartDialogue(Dialogue* dialogue, int node);				// False when the graph has nothing to say from there
+	bool ChooseDialogueAnswer(Dialogue* dialogue, int answer);		// False once the talk is over
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DIALOGUE_H
@@ -0,0 +1,323 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Draw recorder: with DRAW_RECORDER defined the draw calls of render, text, background and
+*   every screen come here instead of raylib (see draw_recorder.h). Between BeginRecordedFrame() and
+*   EndRecordedFrame() they are appended to a command list and nothing reaches GL, so a frame
+*   can be timed, hashed and compared without drawing it. Outside a recorded frame they pass
+*   straight through, render textures still bake for real.
+*
+*   NOTE: raylib still wants a GL context to load textures, machines without a GPU can run it
+*   on a hidden window with Mesa's software driver, the recorded frames never touch it
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#define DRAW_RECORDER_IMPLEMENTATION    // The names below are raylib's own in this file
+#include "raylib.h"
+#include "draw_recorder.h"
+#include "texture_cache.h"
+#include "text.h"
+
+#include <string.h>
+
+// NOTE: From rlgl.h, which include/ does not ship, the function is exported by raylib itself
+void rlSetBlendFactors(int glSrcFactor, int glDstFactor, int glEquation);
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//---------------------------------------------------------------------------------
+static DrawFrame frame = { 0 };
+static bool recording = false;
+static int blendFactors[3] = { 0 };    // Last rlSetBlendFactors(), BLEND_CUSTOM records them
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+static void Record(DrawCommand command)
+{
+    if (frame.count == MAX_DRAW_COMMANDS)
+    {
+        frame.dropped += 1;
+        return;
+    }
+
+    // Taken now, the hash must not depend on GL ids or on textures unloaded later
+    if ((command.type == DRAW_TEXTURE) || (command.type == DRAW_TEXT)) command.identity = GetTextureIdentity(command.texture);
+    else if (command.type == DRAW_BEGIN_TARGET) command.identity = GetTextureIdentity(command.target.texture);
+    else if (command.type == DRAW_BEGIN_SHADER) command.identity = GetShaderIdentity(command.shader);
+
+    frame.commands[frame.count] = command;
+    frame.count += 1;
+}
+
+// FNV-1a, continued from hash
+static unsigned int HashBytes(unsigned int hash, const void* data, int size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (int i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+// Only what decides the pixels, field by field to skip padding and pointers
+static unsigned int HashCommand(unsigned int hash, const DrawCommand* command, const char* text)
+{
+    hash = HashBytes(hash, &command->type, sizeof(command->type));
+
+    switch (command->type)
+    {
+    case DRAW_TEXTURE:
+    case DRAW_TEXT:
+    {
+        hash = HashBytes(hash, &command->identity, sizeof(command->identity));
+        hash = HashBytes(hash, &command->source, sizeof(command->source));
+        hash = HashBytes(hash, &command->dest, sizeof(command->dest));
+        hash = HashBytes(hash, &command->origin, sizeof(command->origin));
+        hash = HashBytes(hash, &command->rotation, sizeof(command->rotation));
+        hash = HashBytes(hash, &command->fontSize, sizeof(command->fontSize));
+        hash = HashBytes(hash, &command->spacing, sizeof(command->spacing));
+        hash = HashBytes(hash, &command->tint, sizeof(command->tint));
+        if (command->type == DRAW_TEXT) hash = HashBytes(hash, text + command->text, (int)strlen(text + command->text));
+    } break;
+    case DRAW_CLEAR:
+    case DRAW_RECTANGLE:
+    case DRAW_BEGIN_SCISSOR:
+    {
+        hash = HashBytes(hash, &command->dest, sizeof(command->dest));
+        hash = HashBytes(hash, &command->tint, sizeof(command->tint));
+    } break;
+    case DRAW_BEGIN_CAMERA:
+    {
+        hash = HashBytes(hash, &command->camera.offset, sizeof(command->camera.offset));
+        hash = HashBytes(hash, &command->camera.target, sizeof(command->camera.target));
+        hash = HashBytes(hash, &command->camera.rotation, sizeof(command->camera.rotation));
+        hash = HashBytes(hash, &command->camera.zoom, sizeof(command->camera.zoom));
+    } break;
+    case DRAW_BEGIN_TARGET: hash = HashBytes(hash, &command->identity, sizeof(command->identity)); break;
+    case DRAW_BEGIN_SHADER: hash = HashBytes(hash, &command->identity, sizeof(command->identity)); break;
+    case DRAW_BEGIN_BLEND: hash = HashBytes(hash, command->blend, sizeof(command->blend)); break;
+    default: break;
+    }
+
+    return hash;
+}
+
+//----------------------------------------------------------------------------------
+// Draw Recorder Functions Definition
+//----------------------------------------------------------------------------------
+void BeginRecordedFrame(void)
+{
+    frame.count = 0;
+    frame.dropped = 0;
+    frame.textUsed = 0;
+    recording = true;
+}
+
+void EndRecordedFrame(void)
+{
+    recording = false;
+
+    if (frame.dropped > 0) TraceLog(LOG_WARNING, "RECORDER: %i draw commands did not fit the frame", frame.dropped);
+}
+
+const DrawFrame* GetRecordedFrame(void)
+{
+    return &frame;
+}
+
+unsigned int HashDrawFrame(const DrawFrame* recorded)
+{
+    unsigned int hash = 2166136261u;
+
+    for (int i = 0; i < recorded->count; ++i) hash = HashCommand(hash, &recorded->commands[i], recorded->text);
+
+    return hash;
+}
+
+int DiffDrawFrames(const DrawFrame* recorded, const DrawFrame* other)
+{
+    int count = (recorded->count < other->count) ? recorded->count : other->count;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (HashCommand(2166136261u, &recorded->commands[i], recorded->text) != HashCommand(2166136261u, &other->commands[i], other->text)) return i;
+    }
+
+    return (recorded->count != other->count) ? count : -1;
+}
+
+void ReplayDrawFrame(const DrawFrame* recorded)
+{
+    for (int i = 0; i < recorded->count; ++i)
+    {
+        const DrawCommand* command = &recorded->commands[i];
+
+        switch (command->type)
+        {
+        case DRAW_CLEAR: ClearBackground(command->tint); break;
+        case DRAW_TEXTURE: DrawTexturePro(command->texture, command->source, command->dest, command->origin, command->rotation, command->tint); break;
+        case DRAW_TEXT:
+        {
+            Vector2 position = { command->dest.x, command->dest.y };
+            DrawTextEx(command->font, recorded->text + command->text, position, command->fontSize, command->spacing, command->tint);
+        } break;
+        case DRAW_RECTANGLE: DrawRectangleRec(command->dest, command->tint); break;
+        case DRAW_BEGIN_CAMERA: BeginMode2D(command->camera); break;
+        case DRAW_END_CAMERA: EndMode2D(); break;
+        case DRAW_BEGIN_TARGET: BeginTextureMode(command->target); break;
+        case DRAW_END_TARGET: EndTextureMode(); break;
+        case DRAW_BEGIN_SCISSOR: BeginScissorMode((int)command->dest.x, (int)command->dest.y, (int)command->dest.width, (int)command->dest.height); break;
+        case DRAW_END_SCISSOR: EndScissorMode(); break;
+        case DRAW_BEGIN_SHADER: BeginShaderMode(command->shader); break;
+        case DRAW_END_SHADER: EndShaderMode(); break;
+        case DRAW_BEGIN_BLEND:
+        {
+            rlSetBlendFactors(command->blend[1], command->blend[2], command->blend[3]);
+            BeginBlendMode(command->blend[0]);
+        } break;
+        case DRAW_END_BLEND: EndBlendMode(); break;
+        default: break;
+        }
+    }
+}
+
+void RecordClearBackground(Color color)
+{
+    if (!recording) ClearBackground(color);
+    else Record((DrawCommand){ .type = DRAW_CLEAR, .tint = color });
+}
+
+void RecordTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint)
+{
+    // Same quad raylib's DrawTextureEx() draws
+    Rectangle source = { 0, 0, (float)texture.width, (float)texture.height };
+    Rectangle dest = { position.x, position.y, texture.width * scale, texture.height * scale };
+
+    if (!recording) DrawTextureEx(texture, position, rotation, scale, tint);
+    else Record((DrawCommand){ .type = DRAW_TEXTURE, .texture = texture, .source = source, .dest = dest, .rotation = rotation, .tint = tint });
+}
+
+void RecordTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    if (!recording) DrawTexturePro(texture, source, dest, origin, rotation, tint);
+    else Record((DrawCommand){ .type = DRAW_TEXTURE, .texture = texture, .source = source, .dest = dest, .origin = origin, .rotation = rotation, .tint = tint });
+}
+
+void RecordTextEx(Font font, const char* text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    if (!recording)
+    {
+        DrawTextEx(font, text, position, fontSize, spacing, tint);
+        return;
+    }
+
+    int length = (int)strlen(text) + 1;
+    if (frame.textUsed + length > MAX_DRAW_TEXT)
+    {
+        frame.dropped += 1;
+        return;
+    }
+
+    memcpy(frame.text + frame.textUsed, text, length);
+    Record((DrawCommand){ .type = DRAW_TEXT, .texture = font.texture, .dest = { position.x, position.y, 0, 0 }, .fontSize = fontSize,
+        .spacing = spacing, .tint = tint, .text = frame.textUsed, .font = font });
+    frame.textUsed += length;
+}
+
+void RecordText(const char* text, int posX, int posY, int fontSize, Color color)
+{
+    if (!recording)
+    {
+        DrawText(text, posX, posY, fontSize, color);
+        return;
+    }
+
+    // Same as raylib's DrawText() does with the default font
+    Font font = GetFontDefault();
+    if (font.texture.id == 0) return;
+    if (fontSize < 10) fontSize = 10;
+
+    RecordTextEx(font, text, (Vector2){ (float)posX, (float)posY }, (float)fontSize, (float)(fontSize / 10), color);
+}
+
+void RecordRectangle(int posX, int posY, int width, int height, Color color)
+{
+    RecordRectangleRec((Rectangle){ (float)posX, (float)posY, (float)width, (float)height }, color);
+}
+
+void RecordRectangleRec(Rectangle rec, Color color)
+{
+    if (!recording) DrawRectangleRec(rec, color);
+    else Record((DrawCommand){ .type = DRAW_RECTANGLE, .dest = rec, .tint = color });
+}
+
+void RecordBeginMode2D(Camera2D camera)
+{
+    if (!recording) BeginMode2D(camera);
+    else Record((DrawCommand){ .type = DRAW_BEGIN_CAMERA, .camera = camera });
+}
+
+void RecordEndMode2D(void)
+{
+    if (!recording) EndMode2D();
+    else Record((DrawCommand){ .type = DRAW_END_CAMERA });
+}
+
+void RecordBeginTextureMode(RenderTexture2D target)
+{
+    if (!recording) BeginTextureMode(target);
+    else Record((DrawCommand){ .type = DRAW_BEGIN_TARGET, .target = target });
+}
+
+void RecordEndTextureMode(void)
+{
+    if (!recording) EndTextureMode();
+    else Record((DrawCommand){ .type = DRAW_END_TARGET });
+}
+
+void RecordBeginScissorMode(int x, int y, int width, int height)
+{
+    if (!recording) BeginScissorMode(x, y, width, height);
+    else Record((DrawCommand){ .type = DRAW_BEGIN_SCISSOR, .dest = { (float)x, (float)y, (float)width, (float)height } });
+}
+
+void RecordEndScissorMode(void)
+{
+    if (!recording) EndScissorMode();
+    else Record((DrawCommand){ .type = DRAW_END_SCISSOR });
+}
+
+void RecordBeginShaderMode(Shader shader)
+{
+    if (!recording) BeginShaderMode(shader);
+    else Record((DrawCommand){ .type = DRAW_BEGIN_SHADER, .shader = shader });
+}
+
+void RecordEndShaderMode(void)
+{
+    if (!recording) EndShaderMode();
+    else Record((DrawCommand){ .type = DRAW_END_SHADER });
+}
+
+void RecordBlendFactors(int glSrcFactor, int glDstFactor, int glEquation)
+{
+    blendFactors[0] = glSrcFactor;
+    blendFactors[1] = glDstFactor;
+    blendFactors[2] = glEquation;
+
+    if (!recording) rlSetBlendFactors(glSrcFactor, glDstFactor, glEquation);
+}
+
+void RecordBeginBlendMode(int mode)
+{
+    if (!recording) BeginBlendMode(mode);
+    else Record((DrawCommand){ .type = DRAW_BEGIN_BLEND, .blend = { mode, blendFactors[0], blendFactors[1], blendFactors[2] } });
+}
+
+void RecordEndBlendMode(void)
+{
+    if (!recording) EndBlendMode();
+    else Record((DrawCommand){ .type = DRAW_END_BLEND });
+}
@@ -0,0 +1,120 @@
+#ifndef DRAW_RECORDER_H
+#define DRAW_RECORDER_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define MAX_DRAW_COMMANDS 4096			// Per frame, more are dropped and counted
+#define MAX_DRAW_TEXT 8192				// DrawTextEx() strings are copied into the frame
+
+typedef enum DrawCommandType
+{
+	DRAW_CLEAR = 0,
+	DRAW_TEXTURE,			// DrawTextureEx() is stored as the DrawTexturePro() it amounts to
+	DRAW_TEXT,
+	DRAW_RECTANGLE,
+	DRAW_BEGIN_CAMERA,		// State the draws above depend on, replayed in order
+	DRAW_END_CAMERA,
+	DRAW_BEGIN_TARGET,
+	DRAW_END_TARGET,
+	DRAW_BEGIN_SCISSOR,
+	DRAW_END_SCISSOR,
+	DRAW_BEGIN_SHADER,
+	DRAW_END_SHADER,
+	DRAW_BEGIN_BLEND,
+	DRAW_END_BLEND
+} DrawCommandType;
+
+typedef struct DrawCommand
+{
+	DrawCommandType type;
+	Texture2D texture;		// Font atlas for text
+	unsigned int identity;	// Of the texture, target or shader, see GetTextureIdentity(), what the hash uses
+	Rectangle source;
+	Rectangle dest;			// Text position in x and y, scissor area
+	Vector2 origin;
+	float rotation;
+	float fontSize;
+	float spacing;
+	Color tint;				// Clear and rectangle color too
+	int text;				// Offset into the frame text
+	Font font;
+	Camera2D camera;
+	RenderTexture2D target;
+	Shader shader;
+	int blend[4];			// Blend mode, then the custom source, destination factors and equation
+} DrawCommand;
+
+typedef struct DrawFrame
+{
+	int count;
+	int dropped;			// Commands past MAX_DRAW_COMMANDS or text past MAX_DRAW_TEXT
+	DrawCommand commands[MAX_DRAW_COMMANDS];
+	int textUsed;
+	char text[MAX_DRAW_TEXT];
+} DrawFrame;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Draw Recorder Functions Declaration
+	//----------------------------------------------------------------------------------
+	void BeginRecordedFrame(void);			// Capture draws from here instead of issuing them
+	void EndRecordedFrame(void);			// Draws go to raylib again, render textures are baked this way
+	const DrawFrame* GetRecordedFrame(void);	// Last frame recorded, valid until the next BeginRecordedFrame()
+	unsigned int HashDrawFrame(const DrawFrame* frame);
+	int DiffDrawFrames(const DrawFrame* frame, const DrawFrame* other);	// First command that differs, -1 if none
+	void ReplayDrawFrame(const DrawFrame* frame);	// Through raylib, call inside BeginDrawing()
+
+	// Stand-ins for the raylib calls below, they pass through while no frame is recorded
+	void RecordClearBackground(Color color);
+	void RecordTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint);
+	void RecordTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+	void RecordTextEx(Font font, const char* text, Vector2 position, float fontSize, float spacing, Color tint);
+	void RecordText(const char* text, int posX, int posY, int fontSize, Color color);
+	void RecordRectangle(int posX, int posY, int width, int height, Color color);
+	void RecordRectangleRec(Rectangle rec, Color color);
+	void RecordBeginMode2D(Camera2D camera);
+	void RecordEndMode2D(void);
+	void RecordBeginTextureMode(RenderTexture2D target);
+	void RecordEndTextureMode(void);
+	void RecordBeginScissorMode(int x, int y, int width, int height);
+	void RecordEndScissorMode(void);
+	void RecordBeginShaderMode(Shader shader);
+	void RecordEndShaderMode(void);
+	void RecordBlendFactors(int glSrcFactor, int glDstFactor, int glEquation);
+	void RecordBeginBlendMode(int mode);
+	void RecordEndBlendMode(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Build with DRAW_RECORDER defined to route the draw calls of every file including this header
+// through the recorder, include it after raylib.h
+#if defined(DRAW_RECORDER) && !defined(DRAW_RECORDER_IMPLEMENTATION)
+#define ClearBackground RecordClearBackground
+#define DrawTextureEx RecordTextureEx
+#define DrawTexturePro RecordTexturePro
+#define DrawTextEx RecordTextEx
+#define DrawText RecordText
+#define DrawRectangle RecordRectangle
+#define DrawRectangleRec RecordRectangleRec
+#define BeginMode2D RecordBeginMode2D
+#define EndMode2D RecordEndMode2D
+#define BeginTextureMode RecordBeginTextureMode
+#define EndTextureMode RecordEndTextureMode
+#define BeginScissorMode RecordBeginScissorMode
+#define EndScissorMode RecordEndScissorMode
+#define BeginShaderMode RecordBeginShaderMode
+#define EndShaderMode RecordEndShaderMode
+#define rlSetBlendFactors RecordBlendFactors
+#define BeginBlendMode RecordBeginBlendMode
+#define EndBlendMode RecordEndBlendMode
+#endif
+
+#endif // DRAW_RECORDER_H
@@ -1,172 +1,179 @@
 #include "raylib.h"
 #include "scenes.h"
+#include "texture_cache.h"
+#include "render.h"
+#include "background.h"
+#include "input.h"
+#include "text_cache.h"
+#include "hotspots.h"
+#include "navigation.h"
 
 #define BACKGROUND_LAYERS 6
+#define FLOOR_TOP 492             // Feet of the player standing at y 300, the old lowest it could go
 #define CLICKABLE_OBJECTS 3
 
-static Texture2D background_layers[BACKGROUND_LAYERS];
+static const BackgroundLayer forestLayers[BACKGROUND_LAYERS] = {
+    { "data/bg.png", { 0, 0 }, 0.5f, LAYER_STATIC },
+    { "data/trees3.png", { 0, 0 }, 0.5f, LAYER_STATIC },
+    { "data/trees2.png", { 0, 0 }, 0.5f, LAYER_STATIC },
+    { "data/trees1.png", { 0, 0 }, 0.5f, LAYER_STATIC },
+    { "data/bushes.png", { 0, 0 }, 0.5f, LAYER_STATIC },
+    { "data/grass.png", { 0, 0 }, 0.5f, LAYER_STATIC },
+};
+
+// Images InitForestScene loads besides the background layers
+static const char* forestSceneSprites[] = {
+    "data/GraveRobber.png", "data/GraveRobber_walk2.png", "data/butterfly1.png",
+    "data/Chest.png", "data/Key.png", "data/Woodcutter.png"
+};
+
+static Background background = { 0 };
+static NavMesh navMesh = { 0 };
+static Camera2D camera = { 0 };         // As last drawn, the mouse is picked through it
 static WorldObject butterfly = { 0 };
-static Dialogue woodcutter_welcome = { 0 };
+static DialogueGraph woodcutter_dialogue = { 0 };
 static NPC woodcutter_npc = { 0 };
 
-static ClickableObject chest = { 0 };
-static ClickableObject key = { 0 };
-static ClickableObject woodcutter = { 0 };
+static SceneObjects objects = { 0 };
 
-static ClickableObject clickableObjects[CLICKABLE_OBJECTS];
-
-static int framesCounter = 0;
 static int showInventory = 0;
 static int showDialogue = 0;
 static int selectedObject = -1;
 static int highlight = -1;
+static HotspotGrid hotspots = { 0 };
+static bool hotspotsMoved = true;     // Clickables moved, appeared or were taken since the grid was built
 
 void InitForestScene(Font font)
 {
-    // Init global variables
-    framesCounter = 0;
-
     // locals
-    framesCounter = 0;
     showInventory = 0;
     showDialogue = 0;
     selectedObject = -1;
     highlight = -1;
+    hotspotsMoved = true;
 
     // BACKGROUNDS ////////////////////////////////////////////////////////////
-    background_layers[0] = LoadTexture("data/bg.png");
-    background_layers[1] = LoadTexture("data/trees3.png");
-    background_layers[2] = LoadTexture("data/trees2.png");
-    background_layers[3] = LoadTexture("data/trees1.png");
-    background_layers[4] = LoadTexture("data/bushes.png");
-    background_layers[5] = LoadTexture("data/grass.png");
+    LoadBackground(&background, forestLayers, BACKGROUND_LAYERS);
+
+    // Whole width of the scene below the floor line, no blockers yet
+    Vector2 corner = { MAX(background.size.x, GetRenderViewSize().x), MAX(background.size.y, GetRenderViewSize().y) };
+    Vector2 floor[] = { { 0, FLOOR_TOP }, { corner.x, FLOOR_TOP }, { corner.x, corner.y }, { 0, corner.y } };
+    LoadNavMesh(&navMesh, floor, 4, 0, 0, NAV_CELL_SIZE);
 
     // PLAYER /////////////////////////////////////////////////////////////////
-    player_idle_animation.sprite = LoadTexture("data/GraveRobber.png");
+    player_idle_animation.sprite = AcquireSprite("data/GraveRobber.png");
     player_idle_animation.total_frames = 1;
 
-    player_walk_animation.sprite = LoadTexture("data/GraveRobber_walk2.png");
+    player_walk_animation.sprite = AcquireSprite("data/GraveRobber_walk2.png");
     player_walk_animation.total_frames = 6;
 
     player.position = (Vector2){ 0, 300};
+    player.previous_position = player.position;
     player.size = (Vector2){ 48, 48 };
     player.scale = (Vector2){ 4, 4 };
     player.animation = player_idle_animation;
+    UpdateWorldObjectBounds(&player);
 
-    player_target = (Vector2){ 0, 300 };
+    StopPlayer();
 
     // BUTTERFLY //////////////////////////////////////////////////////////////
     butterfly.position = (Vector2){ 0, 0 };
     butterfly.size = (Vector2){ 1920, 1080 };
-    butterfly.scale = (Vector2){ 1, 1 };
+    butterfly.scale = (Vector2){ 0.5f, 0.5f };
     butterfly.animation = (Animation){ 0 };
-    butterfly.animation.sprite = LoadTexture("data/butterfly1.png");
+    butterfly.animation.sprite = AcquireSprite("data/butterfly1.png");
+    UpdateWorldObjectBounds(&butterfly);
 
     // DIALOGUE ///////////////////////////////////////////////////////////////
-    woodcutter_welcome.spoken_dialogue = "Hello, World!";
-    woodcutter_welcome.total_answers = 3;
-    woodcutter_welcome.answer_dialogue_options[0] = "Hello Mr.";
-    woodcutter_welcome.answer_dialogue_options[1] = "You say hello, I say goodbye";
-    woodcutter_welcome.answer_dialogue_options[2] = "Goodbye";
-    Vector2 textSize = MeasureTextEx(font, woodcutter_welcome.answer_dialogue_options[0], font.baseSize * 2, 4);
-    woodcutter_welcome.dialogue_location[0] = (Rectangle){ 200, 320, textSize.x, textSize.y };
-    textSize = MeasureTextEx(font, woodcutter_welcome.answer_dialogue_options[1], font.baseSize * 2, 4);
-    woodcutter_welcome.dialogue_location[1] = (Rectangle){ 200, 320 + textSize.y + 5, textSize.x, textSize.y };
-    textSize = MeasureTextEx(font, woodcutter_welcome.answer_dialogue_options[2], font.baseSize * 2, 4);
-    woodcutter_welcome.dialogue_location[2] = (Rectangle){ 200, 320 + ((textSize.y + 5) * 2), textSize.x, textSize.y };
+    // Compiled from tools/dialogue/woodcutter.txt, see tools/dialogue_compiler.c
+    // NOTE: Without the graph the woodcutter has nothing to say, StartDialogue() refuses to start
+    if (!LoadDialogueGraph(&woodcutter_dialogue, "data/woodcutter.dlg"))
+    {
+        TraceLog(LOG_ERROR, "FOREST: [data/woodcutter.dlg] Not loaded, the woodcutter will not talk");
+    }
 
     // WOODCUTTER NPC /////////////////////////////////////////////////////////
-    woodcutter_npc.current_dialogue = 0;
-    woodcutter_npc.dialogue[0] = &woodcutter_welcome;
-
-    // CHEST //////////////////////////////////////////////////////////////////
-    chest.world_item = (WorldObject){ 0 };
-    chest.world_item.position = (Vector2){ 400, 350 };
-    chest.world_item.size = (Vector2){ 32, 32 };
-    chest.world_item.scale = (Vector2){ 4, 4 };
-    chest.world_item.animation = (Animation){ 0 };
-    chest.world_item.animation.sprite = LoadTexture("data/Chest.png");
-    chest.world_item.animation.total_frames = 4;
-    TextCopy(chest.description, "Treasure Chest");
-    chest.canOpen = true;
-    chest.isOpen = false;
-    chest.canTake = false;
-    chest.isTaken = false;
-    chest.canTalk = false;
-    chest.npc = 0;
-
-    // KEY ////////////////////////////////////////////////////////////////////
-    key.world_item = (WorldObject){ 0 };
-    key.world_item.position = (Vector2){ 124, 390 };
-    key.world_item.size = (Vector2){ 8, 8 };
-    key.world_item.scale = (Vector2){ 4, 4 };
-    key.world_item.animation = (Animation){ 0 };
-    key.world_item.animation.sprite = LoadTexture("data/Key.png");
-    key.world_item.animation.total_frames = 4;
-    key.inventory_item = (InventoryObject){0};
-    key.inventory_item.object_sprite = LoadTexture("data/Key.png");
-    TextCopy(key.description, "A silver key");
-    key.canOpen = false;
-    key.isOpen = false;
-    key.canTake = true;
-    key.isTaken = false;
-    key.canTalk = false;
-    key.npc = 0;
-
-    // WOODCUTTER /////////////////////////////////////////////////////////////
-    woodcutter.world_item = (WorldObject){ 0 };
-    woodcutter.world_item.position = (Vector2){ 600, 320 };
-    woodcutter.world_item.size = (Vector2){ 48, 48 };
-    woodcutter.world_item.scale = (Vector2){ 4, 4 };
-    woodcutter.world_item.animation = (Animation){ 0 };
-    woodcutter.world_item.animation.sprite = LoadTexture("data/Woodcutter.png");
-    woodcutter.world_item.animation.total_frames = 4;
-    TextCopy(woodcutter.description, "Man with axe");
-    woodcutter.canOpen = false;
-    woodcutter.isOpen = false;
-    woodcutter.canTake = false;
-    woodcutter.isTaken = false;
-    woodcutter.canTalk = true;
-    woodcutter.npc = &woodcutter_npc;
+    // NOTE: Flags are kept, what was said before is remembered after a visit to the ruins
+    woodcutter_npc.dialogue.graph = &woodcutter_dialogue;
+    woodcutter_npc.dialogue.node = DIALOGUE_END;
+    woodcutter_npc.dialogue.total_answers = 0;
+    woodcutter_npc.dialogue.origin = (Vector2){ 200, 320 };
+    woodcutter_npc.dialogue.fontSize = font.baseSize * 2;
+    woodcutter_npc.dialogue.spacing = 4;
 
     // CLICKABLE OBJECTS //////////////////////////////////////////////////////
-    clickableObjects[0] = chest;
-    clickableObjects[1] = key;
-    clickableObjects[2] = woodcutter;
+    LoadSceneObjects(&objects, CLICKABLE_OBJECTS);
+
+    AddSceneObject(&objects, (Animation){ .sprite = AcquireSprite("data/Chest.png"), .total_frames = 4 },
+        (Vector2){ 400, 350 }, (Vector2){ 32, 32 }, (Vector2){ 4, 4 }, OBJECT_CAN_OPEN, "Treasure Chest");
+
+    int key = AddSceneObject(&objects, (Animation){ .sprite = AcquireSprite("data/Key.png"), .total_frames = 4 },
+        (Vector2){ 124, 390 }, (Vector2){ 8, 8 }, (Vector2){ 4, 4 }, OBJECT_CAN_TAKE, "A silver key");
+    if (key != -1) objects.inventorySprites[key] = AcquireSprite("data/Key.png");
+
+    int woodcutter = AddSceneObject(&objects, (Animation){ .sprite = AcquireSprite("data/Woodcutter.png"), .total_frames = 4 },
+        (Vector2){ 600, 320 }, (Vector2){ 48, 48 }, (Vector2){ 4, 4 }, OBJECT_CAN_TALK, "Man with axe");
+    if (woodcutter != -1) objects.npcs[woodcutter] = &woodcutter_npc;
+
+    camera = FollowCamera(player.bounds, background.size);
+}
+
+const char** GetForestSceneImages(int* count)
+{
+    static const char* images[BACKGROUND_LAYERS + sizeof(forestSceneSprites) / sizeof(forestSceneSprites[0])];
+
+    for (int i = 0; i < BACKGROUND_LAYERS; ++i) images[i] = forestLayers[i].fileName;
+    for (int i = BACKGROUND_LAYERS; i < (int)(sizeof(images) / sizeof(images[0])); ++i) images[i] = forestSceneSprites[i - BACKGROUND_LAYERS];
+
+    *count = sizeof(images) / sizeof(images[0]);
+    return images;
+}
+
+static void UpdateForestHotspots(void)
+{
+    if (!hotspotsMoved) return;
+
+    // Taken items keep an empty rectangle so indices still match objects
+    Rectangle bounds[CLICKABLE_OBJECTS];
+    GetSceneObjectHotspots(&objects, bounds);
+
+    BuildHotspotGrid(&hotspots, bounds, objects.count, HOTSPOT_CELL_SIZE);
+    hotspotsMoved = false;
+}
+
+// Animations step with the fixed update, drawing may happen at any rate
+static void AnimateForestScene(void)
+{
+    AdvanceAnimation(&player.animation);
+    AnimateSceneObjects(&objects);
 }
 
 void UpdateForestScene()
 {
+    player.previous_position = player.position;
+    AnimateForestScene();
+
     dir = 1;
-    hover = 0;
-    highlight = -1;
-    mousePosition = GetMousePosition();
+    mousePosition = GetInputMousePosition();
+    Vector2 worldMouse = GetScreenToWorld2D(mousePosition, camera);
 
     showDialogue = UpdateDialogue(showDialogue);
 
     showInventory = (mousePosition.y < INVENTORY_OPEN) ? 1 : 0;
 
-    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+    if (IsInputMousePressed(MOUSE_LEFT_BUTTON))
     {
         selectedObject = -1;
 
-        player_target.x = mousePosition.x - (player.size.x * player.scale.x) / 2;
-        player_target.y = mousePosition.y - player.size.y * player.scale.y;
-        player_target.y = MAX(player_target.y, 300);
+        WalkPlayerTo(&navMesh, worldMouse);
         player.animation = player_walk_animation;
     }
 
-    for (int i = 0; i < CLICKABLE_OBJECTS; ++i)
+    UpdateForestHotspots();
+    highlight = PickSceneObject(&objects, &hotspots, worldMouse);
+    if ((highlight != -1) && IsInputMousePressed(MOUSE_LEFT_BUTTON))
     {
-        if (CheckCollisionPointRec(mousePosition, WorldObjectToRect(&clickableObjects[i].world_item)))
-        {
-            if (!clickableObjects[i].isTaken)
-                highlight = i;
-            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
-            {
-                selectedObject = i;
-            }
-        }
+        selectedObject = highlight;
     }
 
     if ((int)player.position.x == (int)player_target.x && (int)player.position.y == (int)player_target.y)
@@ -174,19 +181,26 @@ void UpdateForestScene()
         player.animation = player_idle_animation;
         if (selectedObject != -1)
         {
-            if (clickableObjects[selectedObject].canOpen)
+            unsigned char flags = objects.flags[selectedObject];
+
+            if (flags & OBJECT_CAN_OPEN)
             {
-                clickableObjects[selectedObject].isOpen = true;
+                objects.flags[selectedObject] |= OBJECT_OPEN;
             }
-            else if (clickableObjects[selectedObject].canTake)
+            else if (flags & OBJECT_CAN_TAKE)
             {
-                PickUpItem(&clickableObjects[selectedObject]);
+                PickUpItem(&objects, selectedObject);
+                hotspotsMoved = true;
                 selectedObject = -1;
             }
-            else if (clickableObjects[selectedObject].canTalk)
+            else if (flags & OBJECT_CAN_TALK)
             {
-                showDialogue = 1;
-                visible_dialogue = clickableObjects[selectedObject].npc->dialogue[clickableObjects[selectedObject].npc->current_dialogue];
+                NPC* npc = objects.npcs[selectedObject];
+                if (StartDialogue(&npc->dialogue, 0))
+                {
+                    showDialogue = 1;
+                    visible_dialogue = &npc->dialogue;
+                }
                 selectedObject = -1;
             }
         }
@@ -203,69 +217,52 @@ void UpdateForestScene()
 
 void DrawForestScene(Font font)
 {
-    for (int i = 0; i < BACKGROUND_LAYERS; ++i)
-    {
-        DrawTextureEx(background_layers[i], zero, 0, 0.5f, WHITE);
-    }
-    if (++framesCounter >= (60 / player.animation.total_frames))
-    {
-        player.animation.frame = (player.animation.frame + 1) % player.animation.total_frames;
-        framesCounter = 0;
-    }
+    camera = FollowCamera(WorldObjectToDrawRect(&player), background.size);
+    SetRenderCamera(camera);
 
-    DrawTextureEx(butterfly.animation.sprite, butterfly.position, 0, 0.5f, WHITE);
+    DrawBackground(&background);
 
-    for (int i = 0; i < CLICKABLE_OBJECTS; ++i)
+    if (IsInRenderView(butterfly.bounds))
     {
-        if (clickableObjects[i].isTaken)
-            continue;
-        if (clickableObjects[i].isOpen)
-        {
-            clickableObjects[i].world_item.animation.frame = MIN(clickableObjects[i].world_item.animation.frame + 1, clickableObjects[i].world_item.animation.total_frames - 1);
-        }
-        DrawTexturePro(
-            clickableObjects[i].world_item.animation.sprite,
-            (Rectangle) {
-            clickableObjects[i].world_item.size.x* clickableObjects[i].world_item.animation.frame, 0, clickableObjects[i].world_item.size.x, clickableObjects[i].world_item.size.y
-        },
-            WorldObjectToRect(&clickableObjects[i].world_item),
-                zero,
-                0.0f,
-                WHITE
-                );
-
+        Rectangle butterflySource = { 0, 0, butterfly.size.x, butterfly.size.y };
+        SubmitSprite(RENDER_WORLD, butterfly.animation.sprite, butterflySource, butterfly.bounds, WHITE);
     }
 
+    SubmitSceneObjects(&objects, RENDER_WORLD);
+
+    // The camera follows the player, never out of view
     Rectangle source = { player.size.x * player.animation.frame, 0, dir * player.size.x, player.size.y };
-    DrawTexturePro(player.animation.sprite, source, WorldObjectToRect(&player), zero, 0.0f, WHITE);
+    SubmitSprite(RENDER_ACTORS, player.animation.sprite, source, WorldObjectToDrawRect(&player), WHITE);
 
     if (highlight != -1)
     {
-        Vector2 location = { clickableObjects[highlight].world_item.position.x - 40, clickableObjects[highlight].world_item.position.y };
-        DrawTextEx(font, clickableObjects[highlight].description, location, font.baseSize * 2, 4, WHITE);
+        Vector2 location = { objects.positions[highlight].x - 40, objects.positions[highlight].y };
+        SubmitLabel(RENDER_WORLD_TEXT, objects.descriptions[highlight], location, font.baseSize * 2, 4, WHITE);
     }
 
     if (showInventory != 0)
     {
-        DrawRectangle(0, 0, GetScreenWidth(), INVENTORY_OPEN, DARKGRAY);
+        SubmitPanel(RENDER_UI_PANELS, 0, 0, (int)GetRenderViewSize().x, INVENTORY_OPEN, DARKGRAY);
         for (int i = 0; i < player_inventory.items_taken; ++i)
         {
             float scale = 4.0f;
-            Texture2D* sprite = &player_inventory.items[i].object_sprite;
-            Rectangle source = { 0, 0, sprite->width, sprite->height };
-            Rectangle dest = { 20 * i, 20, sprite->width * scale, sprite->height * scale };
-            DrawTexturePro(*sprite, source, dest, zero, 0.0f, WHITE);
+            Sprite* sprite = &player_inventory.items[i].object_sprite;
+            Vector2 size = { sprite->region.width / sprite->scale, sprite->region.height / sprite->scale };
+            Rectangle source = { 0, 0, size.x, size.y };
+            Rectangle dest = { 20 * i, 20, size.x * scale, size.y * scale };
+            SubmitSprite(RENDER_UI, *sprite, source, dest, WHITE);
         }
     }
 
     if (showDialogue != 0)
     {
-        DrawRectangle(0, 300, GetScreenWidth(), DIALOGUE_OPEN, DARKGRAY);
-        DrawTextEx(font, visible_dialogue->spoken_dialogue, (Vector2) { 20, 300 }, font.baseSize * 2, 4, YELLOW);
+        SubmitPanel(RENDER_UI_PANELS, 0, 300, (int)GetRenderViewSize().x, DIALOGUE_OPEN, DARKGRAY);
+        SetTextCacheGroup(TEXT_GROUP_DIALOGUE);     // Evicted when the dialogue closes
+        SubmitLabel(RENDER_UI_TEXT, visible_dialogue->spoken_dialogue, (Vector2) { 20, 300 }, font.baseSize * 2, 4, YELLOW);
         for (int i = 0; i < visible_dialogue->total_answers; ++i)
         {
-            DrawTextEx(
-                font,
+            SubmitLabel(
+                RENDER_UI_TEXT,
                 visible_dialogue->answer_dialogue_options[i],
                 (Vector2) {
                 visible_dialogue->dialogue_location[i].x, visible_dialogue->dialogue_location[i].y
@@ -275,27 +272,21 @@ void DrawForestScene(Font font)
                     hover == i ? GREEN : BLUE);
         }
 
-        DrawTextEx(font, "Exit", (Vector2) { 600, 400 }, font.baseSize, 4, RED);
+        SubmitLabel(RENDER_UI_TEXT, "Exit", (Vector2) { 600, 400 }, font.baseSize, 4, RED);
+        SetTextCacheGroup(TEXT_GROUP_UI);
     }
 }
 
 void UnloadForestScene()
 {
-    for (int i = 0; i < BACKGROUND_LAYERS; ++i)
-    {
-        UnloadTexture(background_layers[i]);
-    }
-    for (int i = 0; i < CLICKABLE_OBJECTS; ++i)
-    {
-        UnloadTexture(clickableObjects[i].world_item.animation.sprite);
-    }
-    for (int i = 0; i < player_inventory.items_taken; ++i)
-    {
-        UnloadTexture(player_inventory.items[i].object_sprite);
-    }
+    UnloadBackground(&background);
+    UnloadHotspotGrid(&hotspots);
+    UnloadNavMesh(&navMesh);
+    UnloadSceneObjects(&objects);
+    UnloadDialogueGraph(&woodcutter_dialogue);
 
-    UnloadTexture(butterfly.animation.sprite);
+    ReleaseSprite(butterfly.animation.sprite);
 
-    UnloadTexture(player_idle_animation.sprite);
-    UnloadTexture(player_walk_animation.sprite);
+    ReleaseSprite(player_idle_animation.sprite);
+    ReleaseSprite(player_walk_animation.sprite);
 }
\ No newline at end of file
@@ -16,6 +16,13 @@
 #include "raylib.h"
 #include "screens.h"
 #include "scenes.h"
+#include "texture_cache.h"
+#include "render.h"
+#include "input.h"
+#include "text_cache.h"
+#include "draw_recorder.h"      // Draw calls are captured instead with DRAW_RECORDER defined
+
+#include <math.h>
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -29,12 +36,20 @@ Animation player_walk_animation;
 Dialogue* visible_dialogue;
 float player_speed;
 Vector2 player_target;
+static NavPath player_path = { 0 };     // Feet positions, player_target is the last one
+static int player_corner = 0;           // Next corner of player_path to walk to
 Vector2 zero;
 Vector2 mousePosition;
 Rectangle exit_location;
 int hover;
 int dir;
 
+// Answer under the mouse, see UpdateDialogue()
+static Dialogue* hoverDialogue = 0;     // Dialogue it was worked out for, none while closed
+static unsigned int hoverNode = DIALOGUE_END;
+static Vector2 hoverMouse = { 0 };
+static int hoverAnswer = -1;
+
 //----------------------------------------------------------------------------------
 // Gameplay Screen Functions Definition
 //----------------------------------------------------------------------------------
@@ -44,75 +59,175 @@ Rectangle WorldObjectToRect(WorldObject* object)
     return (Rectangle) { object->position.x, object->position.y, object->size.x* object->scale.x, object->size.y* object->scale.y };
 }
 
-void PickUpItem(ClickableObject* object)
+// Where the object is drawn this frame, between its last two updated positions
+Rectangle WorldObjectToDrawRect(WorldObject* object)
+{
+    Rectangle rect = WorldObjectToRect(object);
+    rect.x = object->previous_position.x + (object->position.x - object->previous_position.x) * drawAlpha;
+    rect.y = object->previous_position.y + (object->position.y - object->previous_position.y) * drawAlpha;
+    return rect;
+}
+
+// Call whenever position, size or scale change
+void UpdateWorldObjectBounds(WorldObject* object)
 {
-    object->isTaken = true;
-    object->canTake = false;
-    player_inventory.items[player_inventory.items_taken] = object->inventory_item;
+    object->bounds = WorldObjectToRect(object);
+}
+
+// Keep the target in the middle of the screen without showing past the edges of the scene
+Camera2D FollowCamera(Rectangle target, Vector2 sceneSize)
+{
+    Camera2D camera = { 0 };
+    camera.zoom = 1.0f;
+
+    float width = GetRenderViewSize().x;
+    float height = GetRenderViewSize().y;
+    camera.target.x = MIN(MAX(target.x + target.width / 2 - width / 2, 0), MAX(sceneSize.x - width, 0));
+    camera.target.y = MIN(MAX(target.y + target.height / 2 - height / 2, 0), MAX(sceneSize.y - height, 0));
+
+    return camera;
+}
+
+// Loop through all frames once per second
+void AdvanceAnimation(Animation* animation)
+{
+    if (animation->total_frames <= 0) return;
+
+    animation->timer += updateStep;
+
+    if (animation->timer >= 1.0f / animation->total_frames)
+    {
+        animation->frame = (animation->frame + 1) % animation->total_frames;
+        animation->timer = 0.0f;
+    }
+}
+
+// Step through the frames at fps and hold the last one
+void PlayAnimationOnce(Animation* animation, float fps)
+{
+    if (animation->frame >= animation->total_frames - 1) return;
+
+    animation->timer += updateStep;
+
+    while (animation->timer >= 1.0f / fps && animation->frame < animation->total_frames - 1)
+    {
+        animation->frame += 1;
+        animation->timer -= 1.0f / fps;
+    }
+}
+
+void PickUpItem(SceneObjects* objects, int index)
+{
+    objects->flags[index] |= OBJECT_TAKEN;
+    objects->flags[index] &= ~OBJECT_CAN_TAKE;
+    player_inventory.items[player_inventory.items_taken].object_sprite = objects->inventorySprites[index];
+    RetainSprite(objects->inventorySprites[index]);     // Inventory keeps the sprite across scenes
     player_inventory.items_taken += 1;
+    objects->version += 1;
 }
 
+// Answers are only tested again once the mouse moves or another node shows, a click goes to
+// the answer already found and walks the graph on from there
 int UpdateDialogue(int showDialogue)
 {
-    if (showDialogue == 1)
+    hover = 0;
+
+    if (showDialogue != 1)
     {
+        hoverDialogue = 0;
+        return showDialogue;
+    }
+
+    if ((hoverDialogue != visible_dialogue) || (hoverNode != visible_dialogue->node) ||
+        (hoverMouse.x != mousePosition.x) || (hoverMouse.y != mousePosition.y))
+    {
+        hoverAnswer = -1;
         for (int i = 0; i < visible_dialogue->total_answers; ++i)
         {
-            if (CheckCollisionPointRec(mousePosition, visible_dialogue->dialogue_location[i]))
-            {
-                hover = i;
-                if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
-                {
-                    visible_dialogue->answer_selected = true;
-                    visible_dialogue->chosen_answer = i;
-                    return 0;
-                }
-            }
+            if (CheckCollisionPointRec(mousePosition, visible_dialogue->dialogue_location[i])) hoverAnswer = i;
+        }
+
+        hoverDialogue = visible_dialogue;
+        hoverNode = visible_dialogue->node;
+        hoverMouse = mousePosition;
+    }
+
+    if (hoverAnswer != -1) hover = hoverAnswer;
+
+    if (IsInputMousePressed(MOUSE_LEFT_BUTTON))
+    {
+        if (hoverAnswer != -1)
+        {
+            // NOTE: Lines of the node left are not shown again soon, next ones are cached as they draw
+            EvictTextCacheGroup(TEXT_GROUP_DIALOGUE);
+            return ChooseDialogueAnswer(visible_dialogue, hoverAnswer) ? 1 : 0;
         }
 
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+        if (CheckCollisionPointRec(mousePosition, exit_location))
         {
-            if (CheckCollisionPointRec(mousePosition, exit_location))
-            {
-                return 0;
-            }
+            EvictTextCacheGroup(TEXT_GROUP_DIALOGUE);
+            return 0;
         }
     }
 
     return showDialogue;
 }
 
+// Feet are the bottom middle of the sprite, paths are walked with those
+static Vector2 FeetToPosition(Vector2 feet)
+{
+    return (Vector2){ feet.x - (player.size.x * player.scale.x) / 2, feet.y - player.size.y * player.scale.y };
+}
+
+void WalkPlayerTo(NavMesh* mesh, Vector2 point)
+{
+    Vector2 feet = { player.position.x + (player.size.x * player.scale.x) / 2, player.position.y + player.size.y * player.scale.y };
+
+    // No way there, carry on wherever the player was going
+    if (!FindNavPath(mesh, feet, point, &player_path)) return;
+
+    player_corner = 0;
+    player_target = FeetToPosition(player_path.points[player_path.count - 1]);
+}
+
+void StopPlayer(void)
+{
+    player_path.count = 0;
+    player_corner = 0;
+    player_target = player.position;
+}
+
+// Corners in order, what is left of a step carries on past a corner. Each axis moves at
+// player_speed on its own as it always has, so diagonals are walked faster than straights.
 void MovePlayer()
 {
-    if (player_target.x - player.position.x > 0.35f)
-    {
-        player.position.x += GetFrameTime() * player_speed;
-        if (player.position.x > player_target.x)
-            player.position.x = player_target.x;
-    }
-    else if (player_target.x - player.position.x < -0.35f)
-    {
-        player.position.x -= GetFrameTime() * player_speed;
-        dir = -1;
-        if (player.position.x < player_target.x)
-            player.position.x = player_target.x;
-    }
-    else 
-    {
-        player.position.x = player_target.x;
-    }
-    if (player_target.y - player.position.y > 0.1f)
-    {
-        player.position.y += GetFrameTime() * player_speed;
-    }
-    else if (player_target.y - player.position.y < -0.1f)
-    {
-        player.position.y -= GetFrameTime() * player_speed;
-    }
-    else
+    float step = updateStep * player_speed;
+
+    while (step > 0.0f)
     {
-        player.position.y = player_target.y;
+        Vector2 corner = (player_corner < player_path.count) ? FeetToPosition(player_path.points[player_corner]) : player_target;
+        float dx = corner.x - player.position.x;
+        float dy = corner.y - player.position.y;
+        float distance = fmaxf(fabsf(dx), fabsf(dy));      // The axis with further to go decides when it is reached
+
+        if (dx < -0.35f) dir = -1;
+
+        if (distance <= step)
+        {
+            player.position = corner;
+            step -= distance;
+            if (player_corner >= player_path.count) break;
+            player_corner += 1;
+        }
+        else
+        {
+            player.position.x += fmaxf(-step, fminf(dx, step));
+            player.position.y += fmaxf(-step, fminf(dy, step));
+            step = 0.0f;
+        }
     }
+
+    UpdateWorldObjectBounds(&player);
 }
 
 void ChangeScene(GameScene scene)
@@ -136,6 +251,9 @@ void ChangeScene(GameScene scene)
         InitRuinsScene(font);
         break;
     }
+
+    // NOTE: The previous scene stays resident until the texture budget needs the room
+    TraceTextureCacheStats((scene == FOREST) ? "FOREST" : "RUINS");
 }
 
 void InitGameplayScreen(void)
@@ -151,11 +269,18 @@ void InitGameplayScreen(void)
     player_inventory = (Inventory){0, {0}};
     player_speed = 75.0f;
     player_target = (Vector2){0, 300};
+    player_path.count = 0;
     exit_location = (Rectangle){600, 400, 25, 25};
     
     InitForestScene(font);
 }
 
+const char** GetGameplayScreenImages(int* count)
+{
+    // Gameplay always starts in the forest, see InitGameplayScreen()
+    return GetForestSceneImages(count);
+}
+
 void UpdateGameplayScreen(void)
 {
     switch (current_scene)
@@ -195,6 +320,12 @@ void UnloadGameplayScreen(void)
         UnloadRuinsScene();
         break;
     }
+
+    for (int i = 0; i < player_inventory.items_taken; ++i)
+    {
+        ReleaseSprite(player_inventory.items[i].object_sprite);
+    }
+    player_inventory.items_taken = 0;
 }
 
 int FinishGameplayScreen(void)
@@ -0,0 +1,63 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Hit masks: clickables are picked by their rectangle, which covers every transparent pixel
+*   around the art. A mask keeps one bit of the image alpha per pixel, baked at scene load for
+*   the textures of clickable sprites, so a pick can be made exact afterwards without reading
+*   the texture or its image back.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "hit_mask.h"
+
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Hit Mask Functions Definition
+//----------------------------------------------------------------------------------
+HitMask BakeHitMask(Image image)
+{
+    HitMask mask = { 0 };
+
+    // NOTE: Compressed images have no pixels to read, they get no mask and are never hit
+    Color* pixels = LoadImageColors(image);
+    if (pixels == NULL) return mask;
+
+    mask.width = image.width;
+    mask.height = image.height;
+    mask.stride = (image.width + 63) / 64;
+    mask.words = (uint64_t*)MemAlloc(mask.stride * mask.height * sizeof(uint64_t));
+    memset(mask.words, 0, mask.stride * mask.height * sizeof(uint64_t));
+
+    for (int y = 0; y < mask.height; ++y)
+    {
+        uint64_t* row = mask.words + y * mask.stride;
+        const Color* pixel = pixels + y * mask.width;
+
+        for (int x = 0; x < mask.width; ++x)
+        {
+            if (pixel[x].a >= HIT_MASK_ALPHA) row[x / 64] |= (uint64_t)1 << (x % 64);
+        }
+    }
+
+    UnloadImageColors(pixels);
+
+    return mask;
+}
+
+void UnloadHitMask(HitMask* mask)
+{
+    MemFree(mask->words);
+    *mask = (HitMask){ 0 };
+}
+
+bool IsHitMaskSet(const HitMask* mask, int x, int y)
+{
+    if ((mask->words == NULL) || (x < 0) || (y < 0) || (x >= mask->width) || (y >= mask->height)) return false;
+
+    return (mask->words[y * mask->stride + x / 64] >> (x % 64)) & 1;
+}
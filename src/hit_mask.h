@@ -0,0 +1,37 @@
+#ifndef HIT_MASK_H
+#define HIT_MASK_H
+
+#include "raylib.h"
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define HIT_MASK_ALPHA 128				// Pixels at least this opaque can be clicked
+
+// One bit per image pixel, set where the pixel is solid, rows packed 64 pixels per word
+typedef struct HitMask
+{
+	int width;
+	int height;
+	int stride;				// Words per row
+	uint64_t* words;
+} HitMask;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Hit Mask Functions Declaration
+	//----------------------------------------------------------------------------------
+	HitMask BakeHitMask(Image image);			// Reads the pixels once, keep the mask rather than the image
+	void UnloadHitMask(HitMask* mask);
+	bool IsHitMaskSet(const HitMask* mask, int x, int y);	// False outside the mask
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HIT_MASK_H
@@ -0,0 +1,143 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Hotspots: picking used to test the mouse against every clickable in the scene. The grid
+*   buckets hotspot bounds into fixed size cells once, a lookup only tests the few hotspots
+*   sharing the mouse's cell, from the top down, so it stops at the first hit.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "hotspots.h"
+
+#include <math.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+static bool IsEmpty(Rectangle rect)
+{
+    return (rect.width <= 0.0f) || (rect.height <= 0.0f);
+}
+
+static int CellColumn(const HotspotGrid* grid, float x)
+{
+    int column = (int)((x - grid->area.x) / grid->cellSize);
+    return (column < 0) ? 0 : (column >= grid->columns) ? grid->columns - 1 : column;
+}
+
+static int CellRow(const HotspotGrid* grid, float y)
+{
+    int row = (int)((y - grid->area.y) / grid->cellSize);
+    return (row < 0) ? 0 : (row >= grid->rows) ? grid->rows - 1 : row;
+}
+
+// Visit every cell a hotspot overlaps, counting in the first pass and filling in the second
+static void BucketHotspots(HotspotGrid* grid, int* cursor, bool fill)
+{
+    for (int i = 0; i < grid->count; ++i)
+    {
+        Rectangle rect = grid->bounds[i];
+        if (IsEmpty(rect)) continue;
+
+        int lastColumn = CellColumn(grid, rect.x + rect.width);
+        int lastRow = CellRow(grid, rect.y + rect.height);
+
+        for (int row = CellRow(grid, rect.y); row <= lastRow; ++row)
+        {
+            for (int column = CellColumn(grid, rect.x); column <= lastColumn; ++column)
+            {
+                int cell = row * grid->columns + column;
+
+                if (fill) grid->entries[cursor[cell]] = i;
+                cursor[cell] += 1;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Hotspot Functions Definition
+//----------------------------------------------------------------------------------
+void BuildHotspotGrid(HotspotGrid* grid, const Rectangle* bounds, int count, float cellSize)
+{
+    UnloadHotspotGrid(grid);
+
+    grid->count = count;
+    grid->bounds = (Rectangle*)MemAlloc(((count > 0) ? count : 1) * sizeof(Rectangle));
+    if (count > 0) memcpy(grid->bounds, bounds, count * sizeof(Rectangle));
+
+    // Cells only cover where there are hotspots
+    bool any = false;
+    for (int i = 0; i < count; ++i)
+    {
+        if (IsEmpty(bounds[i])) continue;
+
+        if (!any) grid->area = bounds[i];
+        else
+        {
+            float right = fmaxf(grid->area.x + grid->area.width, bounds[i].x + bounds[i].width);
+            float bottom = fmaxf(grid->area.y + grid->area.height, bounds[i].y + bounds[i].height);
+            grid->area.x = fminf(grid->area.x, bounds[i].x);
+            grid->area.y = fminf(grid->area.y, bounds[i].y);
+            grid->area.width = right - grid->area.x;
+            grid->area.height = bottom - grid->area.y;
+        }
+        any = true;
+    }
+
+    grid->cellSize = cellSize;
+    while ((ceilf(grid->area.width / grid->cellSize) * ceilf(grid->area.height / grid->cellSize)) > MAX_HOTSPOT_CELLS) grid->cellSize *= 2.0f;
+
+    grid->columns = any ? (int)fmaxf(ceilf(grid->area.width / grid->cellSize), 1.0f) : 1;
+    grid->rows = any ? (int)fmaxf(ceilf(grid->area.height / grid->cellSize), 1.0f) : 1;
+
+    int cells = grid->columns * grid->rows;
+    grid->cellStart = (int*)MemAlloc((cells + 1) * sizeof(int));
+    memset(grid->cellStart, 0, (cells + 1) * sizeof(int));
+
+    // Count, turn counts into offsets, then fill with a cursor per cell
+    BucketHotspots(grid, grid->cellStart + 1, false);
+    for (int cell = 0; cell < cells; ++cell) grid->cellStart[cell + 1] += grid->cellStart[cell];
+
+    int entryCount = grid->cellStart[cells];
+    grid->entries = (int*)MemAlloc(((entryCount > 0) ? entryCount : 1) * sizeof(int));
+
+    int* cursor = (int*)MemAlloc(cells * sizeof(int));
+    memcpy(cursor, grid->cellStart, cells * sizeof(int));
+    BucketHotspots(grid, cursor, true);
+    MemFree(cursor);
+}
+
+void UnloadHotspotGrid(HotspotGrid* grid)
+{
+    MemFree(grid->bounds);
+    MemFree(grid->cellStart);
+    MemFree(grid->entries);
+
+    *grid = (HotspotGrid){ 0 };
+}
+
+int FindHotspot(const HotspotGrid* grid, Vector2 point)
+{
+    return FindHotspotBelow(grid, point, grid->count);
+}
+
+int FindHotspotBelow(const HotspotGrid* grid, Vector2 point, int below)
+{
+    if ((grid->cellStart == NULL) || !CheckCollisionPointRec(point, grid->area)) return -1;
+
+    int cell = CellRow(grid, point.y) * grid->columns + CellColumn(grid, point.x);
+
+    for (int entry = grid->cellStart[cell + 1] - 1; entry >= grid->cellStart[cell]; --entry)
+    {
+        int i = grid->entries[entry];
+        if ((i < below) && CheckCollisionPointRec(point, grid->bounds[i])) return i;
+    }
+
+    return -1;
+}
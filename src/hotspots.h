@@ -0,0 +1,42 @@
+#ifndef HOTSPOTS_H
+#define HOTSPOTS_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define HOTSPOT_CELL_SIZE 128			// Scene pixels, about the size of a clickable at 4x
+#define MAX_HOTSPOT_CELLS 65536			// Cells grow past HOTSPOT_CELL_SIZE for larger scenes
+
+// Uniform grid over hotspot bounds, each cell lists the hotspots overlapping it in index order.
+// Build it again when a hotspot moves, appears or goes away.
+typedef struct HotspotGrid
+{
+	int count;
+	Rectangle* bounds;		// Copy of what it was built from, empty ones are never hit
+	Rectangle area;			// Union of the bounds, the cells cover exactly this
+	float cellSize;
+	int columns;
+	int rows;
+	int* cellStart;			// Per cell, offset of its first entry, one extra at the end
+	int* entries;			// Hotspot indices, ascending within a cell
+} HotspotGrid;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Hotspot Functions Declaration
+	//----------------------------------------------------------------------------------
+	void BuildHotspotGrid(HotspotGrid* grid, const Rectangle* bounds, int count, float cellSize);
+	void UnloadHotspotGrid(HotspotGrid* grid);
+	int FindHotspot(const HotspotGrid* grid, Vector2 point);	// Topmost, the highest index containing point, -1 if none
+	int FindHotspotBelow(const HotspotGrid* grid, Vector2 point, int below);	// Next one down, when the one above was passed over
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOTSPOTS_H
@@ -0,0 +1,392 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Input: raylib reports presses per rendered frame, game logic runs on a fixed timestep
+*   that may tick several times in one frame or not at all. Presses are latched here until
+*   an update consumes them, so none is seen twice or dropped.
+*
+*   Every frame's input, frame time included, can be recorded to a file and replayed later.
+*   Updates only see what went through here, so a replay takes the same steps as the session
+*   it came from. Each frame is written as what changed since the frame before:
+*
+*       flags byte, INPUT_FRAME_* bits, then for each bit set in this order
+*           TIME        zigzag varint, microseconds more than the last frame time
+*           MOUSE       zigzag varints dx and dy, in 1/INPUT_MOUSE_SUBPIXELS pixels
+*           BUTTONS     byte, a bit per mouse button pressed
+*           KEYS        varint count, then a varint key code each
+*       or INPUT_FRAME_IDLE on its own and a varint count of frames where nothing changed
+*
+*   Time and mouse are rounded to what the file holds while playing live as well, so a
+*   recorded session runs on the very numbers its replay will.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "input.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define INPUT_FILE_MAGIC "LTIN"
+#define INPUT_FILE_VERSION 1
+#define INPUT_FLUSH_FRAMES 60           // Frames written between flushes, a crash loses less than that
+
+#define INPUT_FRAME_TIME 0x01
+#define INPUT_FRAME_MOUSE 0x02
+#define INPUT_FRAME_BUTTONS 0x04
+#define INPUT_FRAME_KEYS 0x08
+#define INPUT_FRAME_TAP 0x10
+#define INPUT_FRAME_IDLE 0x80
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum InputMode { INPUT_LIVE = 0, INPUT_RECORDING, INPUT_REPLAYING } InputMode;
+
+// What one rendered frame brought, as the file holds it
+typedef struct InputFrame
+{
+    unsigned int micros;            // Frame time
+    int mouseX;                     // Subpixels
+    int mouseY;
+    unsigned char buttons;          // Bit per button pressed this frame
+    bool tapped;
+    int keyCount;
+    int keys[MAX_FRAME_KEYS];
+} InputFrame;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//---------------------------------------------------------------------------------
+static bool keys[MAX_INPUT_KEYS] = { 0 };
+static bool buttons[MAX_INPUT_BUTTONS] = { 0 };
+static bool tapped = false;
+static Vector2 mouse = { 0 };
+
+static double lastTime = -1.0;      // GetTime() at the last frame, negative before the first
+static double frameTime = 0.0;
+
+// Recording and replay, see StartInputRecording() and StartInputReplay()
+static InputMode mode = INPUT_LIVE;
+static InputFrame previous = { 0 }; // Frames are written and read as a change to this one
+static int idleFrames = 0;          // Recording, not written yet. Replaying, still to play
+static int capturedFrames = 0;
+static bool replayDone = false;
+
+static FILE* recording = NULL;
+static unsigned char* replay = NULL;
+static int replaySize = 0;
+static int replayOffset = 0;
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+static int WriteVarint(unsigned char* data, int offset, unsigned int value)
+{
+    while (value >= 0x80)
+    {
+        data[offset++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+
+    data[offset++] = (unsigned char)value;
+    return offset;
+}
+
+// Small changes either way take one byte
+static int WriteSigned(unsigned char* data, int offset, int value)
+{
+    return WriteVarint(data, offset, ((unsigned int)value << 1) ^ (unsigned int)(value >> 31));
+}
+
+static unsigned int ReadVarint(void)
+{
+    unsigned int value = 0;
+
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        if (replayOffset >= replaySize)
+        {
+            replayDone = true;
+            break;
+        }
+
+        unsigned char byte = replay[replayOffset++];
+        value |= (unsigned int)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+    }
+
+    return value;
+}
+
+static int ReadSigned(void)
+{
+    unsigned int value = ReadVarint();
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+static void WriteIdleFrames(void)
+{
+    if (idleFrames == 0) return;
+
+    unsigned char data[8] = { INPUT_FRAME_IDLE };
+    int size = WriteVarint(data, 1, idleFrames);
+    fwrite(data, 1, size, recording);
+    idleFrames = 0;
+}
+
+static void RecordFrame(const InputFrame* frame)
+{
+    unsigned char flags = 0;
+    if (frame->micros != previous.micros) flags |= INPUT_FRAME_TIME;
+    if ((frame->mouseX != previous.mouseX) || (frame->mouseY != previous.mouseY)) flags |= INPUT_FRAME_MOUSE;
+    if (frame->buttons != 0) flags |= INPUT_FRAME_BUTTONS;
+    if (frame->keyCount > 0) flags |= INPUT_FRAME_KEYS;
+    if (frame->tapped) flags |= INPUT_FRAME_TAP;
+
+    capturedFrames += 1;
+
+    if (flags == 0)
+    {
+        idleFrames += 1;
+        return;
+    }
+
+    WriteIdleFrames();
+
+    unsigned char data[16 + 5 * MAX_FRAME_KEYS] = { flags };
+    int size = 1;
+    if (flags & INPUT_FRAME_TIME) size = WriteSigned(data, size, (int)(frame->micros - previous.micros));
+    if (flags & INPUT_FRAME_MOUSE)
+    {
+        size = WriteSigned(data, size, frame->mouseX - previous.mouseX);
+        size = WriteSigned(data, size, frame->mouseY - previous.mouseY);
+    }
+    if (flags & INPUT_FRAME_BUTTONS) data[size++] = frame->buttons;
+    if (flags & INPUT_FRAME_KEYS)
+    {
+        size = WriteVarint(data, size, frame->keyCount);
+        for (int i = 0; i < frame->keyCount; ++i) size = WriteVarint(data, size, frame->keys[i]);
+    }
+
+    fwrite(data, 1, size, recording);
+    previous = *frame;
+
+    if ((capturedFrames % INPUT_FLUSH_FRAMES) == 0) fflush(recording);
+}
+
+// Past the end of the file frames keep the last time and mouse and bring no presses
+static void ReplayFrame(InputFrame* frame)
+{
+    *frame = (InputFrame){ .micros = previous.micros, .mouseX = previous.mouseX, .mouseY = previous.mouseY };
+
+    if (idleFrames > 0)
+    {
+        idleFrames -= 1;
+        capturedFrames += 1;
+        return;
+    }
+
+    if (replayOffset >= replaySize)
+    {
+        replayDone = true;
+        return;
+    }
+
+    unsigned char flags = replay[replayOffset++];
+
+    if (flags & INPUT_FRAME_IDLE)
+    {
+        idleFrames = (int)ReadVarint() - 1;
+        capturedFrames += 1;
+        return;
+    }
+
+    if (flags & INPUT_FRAME_TIME) frame->micros += ReadSigned();
+    if (flags & INPUT_FRAME_MOUSE)
+    {
+        frame->mouseX += ReadSigned();
+        frame->mouseY += ReadSigned();
+    }
+    if ((flags & INPUT_FRAME_BUTTONS) && (replayOffset < replaySize)) frame->buttons = replay[replayOffset++];
+    if (flags & INPUT_FRAME_KEYS)
+    {
+        int count = (int)ReadVarint();
+        for (int i = 0; i < count; ++i)
+        {
+            int key = (int)ReadVarint();
+            if (frame->keyCount < MAX_FRAME_KEYS) frame->keys[frame->keyCount++] = key;
+        }
+    }
+    frame->tapped = (flags & INPUT_FRAME_TAP) != 0;
+
+    // NOTE: A file cut short mid frame ends the replay before that frame
+    if (replayDone)
+    {
+        *frame = (InputFrame){ .micros = previous.micros, .mouseX = previous.mouseX, .mouseY = previous.mouseY };
+        return;
+    }
+
+    previous = *frame;
+    capturedFrames += 1;
+}
+
+//----------------------------------------------------------------------------------
+// Input Functions Definition
+//----------------------------------------------------------------------------------
+void UpdateInput(void)
+{
+    InputFrame frame = { 0 };
+
+    // NOTE: Drains raylib's key queue, IsKeyPressed() keeps working for frame level keys
+    for (int key = GetKeyPressed(); key != 0; key = GetKeyPressed())
+    {
+        if (key > 0 && key < MAX_INPUT_KEYS && frame.keyCount < MAX_FRAME_KEYS) frame.keys[frame.keyCount++] = key;
+    }
+
+    for (int i = 0; i < MAX_INPUT_BUTTONS; ++i) frame.buttons |= IsMouseButtonPressed(i) << i;
+
+    frame.tapped = IsGestureDetected(GESTURE_TAP);
+
+    Vector2 position = GetMousePosition();
+    frame.mouseX = (int)lroundf(position.x * INPUT_MOUSE_SUBPIXELS);
+    frame.mouseY = (int)lroundf(position.y * INPUT_MOUSE_SUBPIXELS);
+
+    double now = GetTime();
+    if (lastTime < 0.0) lastTime = now;
+    frame.micros = (unsigned int)llround((now - lastTime) * 1e6);
+    lastTime = now;
+
+    // Live input polled above is dropped while replaying
+    if (mode == INPUT_RECORDING) RecordFrame(&frame);
+    else if (mode == INPUT_REPLAYING) ReplayFrame(&frame);
+
+    for (int i = 0; i < frame.keyCount; ++i)
+    {
+        if (frame.keys[i] > 0 && frame.keys[i] < MAX_INPUT_KEYS) keys[frame.keys[i]] = true;
+    }
+
+    for (int i = 0; i < MAX_INPUT_BUTTONS; ++i) buttons[i] |= (frame.buttons >> i) & 1;
+
+    tapped |= frame.tapped;
+    mouse = (Vector2){ (float)frame.mouseX / INPUT_MOUSE_SUBPIXELS, (float)frame.mouseY / INPUT_MOUSE_SUBPIXELS };
+    frameTime = frame.micros / 1e6;
+}
+
+void ConsumeInput(void)
+{
+    for (int i = 0; i < MAX_INPUT_KEYS; ++i) keys[i] = false;
+    for (int i = 0; i < MAX_INPUT_BUTTONS; ++i) buttons[i] = false;
+
+    tapped = false;
+}
+
+bool IsInputKeyPressed(int key)
+{
+    return (key > 0 && key < MAX_INPUT_KEYS) ? keys[key] : false;
+}
+
+bool IsInputMousePressed(int button)
+{
+    return (button >= 0 && button < MAX_INPUT_BUTTONS) ? buttons[button] : false;
+}
+
+bool IsInputTapped(void)
+{
+    return tapped;
+}
+
+Vector2 GetInputMousePosition(void)
+{
+    return mouse;
+}
+
+double GetInputFrameTime(void)
+{
+    return frameTime;
+}
+
+bool StartInputRecording(const char* fileName)
+{
+    StopInputCapture();
+
+    recording = fopen(fileName, "wb");
+    if (recording == NULL)
+    {
+        TraceLog(LOG_WARNING, "INPUT: [%s] Failed to open file for recording", fileName);
+        return false;
+    }
+
+    unsigned char header[5] = { 0 };
+    memcpy(header, INPUT_FILE_MAGIC, 4);
+    header[4] = INPUT_FILE_VERSION;
+    fwrite(header, 1, sizeof(header), recording);
+
+    mode = INPUT_RECORDING;
+    TraceLog(LOG_INFO, "INPUT: [%s] Recording input", fileName);
+    return true;
+}
+
+bool StartInputReplay(const char* fileName)
+{
+    StopInputCapture();
+
+    unsigned int size = 0;
+    replay = LoadFileData(fileName, &size);
+
+    if ((replay == NULL) || (size < 5) || (memcmp(replay, INPUT_FILE_MAGIC, 4) != 0) || (replay[4] != INPUT_FILE_VERSION))
+    {
+        TraceLog(LOG_WARNING, "INPUT: [%s] Not an input recording of version %i", fileName, INPUT_FILE_VERSION);
+        if (replay != NULL) UnloadFileData(replay);
+        replay = NULL;
+        return false;
+    }
+
+    replaySize = (int)size;
+    replayOffset = 5;
+    mode = INPUT_REPLAYING;
+    TraceLog(LOG_INFO, "INPUT: [%s] Replaying %i bytes of input", fileName, replaySize);
+    return true;
+}
+
+void StopInputCapture(void)
+{
+    if (mode == INPUT_RECORDING)
+    {
+        WriteIdleFrames();
+        TraceLog(LOG_INFO, "INPUT: Recorded %i frames in %li bytes", capturedFrames, ftell(recording));
+        fclose(recording);
+        recording = NULL;
+    }
+    else if (mode == INPUT_REPLAYING)
+    {
+        TraceLog(LOG_INFO, "INPUT: Replayed %i frames", capturedFrames);
+        UnloadFileData(replay);
+        replay = NULL;
+    }
+
+    mode = INPUT_LIVE;
+    previous = (InputFrame){ 0 };
+    idleFrames = 0;
+    capturedFrames = 0;
+    replaySize = 0;
+    replayOffset = 0;
+    replayDone = false;
+}
+
+bool IsInputCapturing(void)
+{
+    return mode != INPUT_LIVE;
+}
+
+bool IsInputReplayDone(void)
+{
+    return (mode == INPUT_REPLAYING) && replayDone;
+}
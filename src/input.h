@@ -0,0 +1,39 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define MAX_INPUT_KEYS 512			// Key codes latched, covers every KeyboardKey
+#define MAX_INPUT_BUTTONS 3			// Left, right and middle mouse buttons
+#define MAX_FRAME_KEYS 16			// Key presses kept from one rendered frame
+#define INPUT_MOUSE_SUBPIXELS 8		// Mouse positions are rounded to 1/8 of a pixel
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Input Functions Declaration
+	//----------------------------------------------------------------------------------
+	void UpdateInput(void);						// Once per rendered frame, latches what raylib polled
+	void ConsumeInput(void);					// After a fixed update, each press is seen by one update only
+	bool IsInputKeyPressed(int key);
+	bool IsInputMousePressed(int button);
+	bool IsInputTapped(void);
+	Vector2 GetInputMousePosition(void);		// Sampled at UpdateInput()
+	double GetInputFrameTime(void);				// Seconds since the previous UpdateInput(), from the file when replaying
+
+	bool StartInputRecording(const char* fileName);	// Every frame from the next UpdateInput() on goes to the file
+	bool StartInputReplay(const char* fileName);	// Frames come from the file instead of raylib
+	void StopInputCapture(void);				// Finishes the recording file, back to live input
+	bool IsInputCapturing(void);				// Recording or replaying, updates have to run the same steps every run
+	bool IsInputReplayDone(void);				// Every recorded frame has been played
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INPUT_H
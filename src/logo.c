@@ -25,11 +25,25 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "draw_recorder.h"      // Draw calls are captured instead with DRAW_RECORDER defined
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+// Timings in seconds, the same as the frame counts they replace took at 60 updates per second
+#define LOGO_BLINK_TIME (80.0f / 60.0f)     // Corner blinking before the bars grow
+#define LOGO_BLINKS_PER_SECOND 6.0f         // Half on, half off
+#define LOGO_BAR_SPEED 480.0f               // Pixels per second
+#define LOGO_BAR_LENGTH 256.0f
+#define LOGO_LETTER_TIME (12.0f / 60.0f)    // One more letter of "raylib"
+#define LOGO_CREDIT_TIME (20.0f / 60.0f)    // "powered by" shows this long after the last letter
+#define LOGO_HOLD_TIME 2.0f                 // After the last letter, before fading
+#define LOGO_FADE_SPEED 1.2f                // Alpha per second
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
 //----------------------------------------------------------------------------------
-static int framesCounter = 0;
+static float timer = 0.0f;         // Seconds into the current state
 static int finishScreen = 0;
 
 static int logoPositionX = 0;
@@ -37,11 +51,11 @@ static int logoPositionY = 0;
 
 static int lettersCount = 0;
 
-static int topSideRecWidth = 0;
-static int leftSideRecHeight = 0;
+static float topSideRecWidth = 0;
+static float leftSideRecHeight = 0;
 
-static int bottomSideRecWidth = 0;
-static int rightSideRecHeight = 0;
+static float bottomSideRecWidth = 0;
+static float rightSideRecHeight = 0;
 
 static int state = 0;              // Logo animation states
 static float alpha = 1.0f;         // Useful for fading
@@ -54,7 +68,7 @@ static float alpha = 1.0f;         // Useful for fading
 void InitLogoScreen(void)
 {
     finishScreen = 0;
-    framesCounter = 0;
+    timer = 0.0f;
     lettersCount = 0;
 
     logoPositionX = GetScreenWidth() / 2 - 128;
@@ -74,45 +88,55 @@ void UpdateLogoScreen(void)
 {
     if (state == 0)                 // State 0: Top-left square corner blink logic
     {
-        framesCounter++;
+        timer += updateStep;
 
-        if (framesCounter == 80)
+        if (timer >= LOGO_BLINK_TIME)
         {
             state = 1;
-            framesCounter = 0;      // Reset counter... will be used later...
+            timer = 0.0f;           // Reset timer... will be used later...
         }
     }
     else if (state == 1)            // State 1: Bars animation logic: top and left
     {
-        topSideRecWidth += 8;
-        leftSideRecHeight += 8;
+        topSideRecWidth += LOGO_BAR_SPEED * updateStep;
+        leftSideRecHeight += LOGO_BAR_SPEED * updateStep;
 
-        if (topSideRecWidth == 256) state = 2;
+        if (topSideRecWidth >= LOGO_BAR_LENGTH)
+        {
+            topSideRecWidth = LOGO_BAR_LENGTH;
+            leftSideRecHeight = LOGO_BAR_LENGTH;
+            state = 2;
+        }
     }
     else if (state == 2)            // State 2: Bars animation logic: bottom and right
     {
-        bottomSideRecWidth += 8;
-        rightSideRecHeight += 8;
+        bottomSideRecWidth += LOGO_BAR_SPEED * updateStep;
+        rightSideRecHeight += LOGO_BAR_SPEED * updateStep;
 
-        if (bottomSideRecWidth == 256) state = 3;
+        if (bottomSideRecWidth >= LOGO_BAR_LENGTH)
+        {
+            bottomSideRecWidth = LOGO_BAR_LENGTH;
+            rightSideRecHeight = LOGO_BAR_LENGTH;
+            state = 3;
+        }
     }
     else if (state == 3)            // State 3: "raylib" text-write animation logic
     {
-        framesCounter++;
+        timer += updateStep;
 
         if (lettersCount < 10)
         {
-            if (framesCounter / 12)   // Every 12 frames, one more letter!
+            if (timer >= LOGO_LETTER_TIME)  // Every LOGO_LETTER_TIME, one more letter!
             {
                 lettersCount++;
-                framesCounter = 0;
+                timer -= LOGO_LETTER_TIME;
             }
         }
         else    // When all letters have appeared, just fade out everything
         {
-            if (framesCounter > 120)
+            if (timer > LOGO_HOLD_TIME)
             {
-                alpha -= 0.02f;
+                alpha -= LOGO_FADE_SPEED * updateStep;
 
                 if (alpha <= 0.0f)
                 {
@@ -129,34 +153,34 @@ void DrawLogoScreen(void)
 {
     if (state == 0)         // Draw blinking top-left square corner
     {
-        if ((framesCounter / 10) % 2) DrawRectangle(logoPositionX, logoPositionY, 16, 16, BLACK);
+        if ((int)(timer * LOGO_BLINKS_PER_SECOND) % 2) DrawRectangle(logoPositionX, logoPositionY, 16, 16, BLACK);
     }
     else if (state == 1)    // Draw bars animation: top and left
     {
-        DrawRectangle(logoPositionX, logoPositionY, topSideRecWidth, 16, BLACK);
-        DrawRectangle(logoPositionX, logoPositionY, 16, leftSideRecHeight, BLACK);
+        DrawRectangle(logoPositionX, logoPositionY, (int)topSideRecWidth, 16, BLACK);
+        DrawRectangle(logoPositionX, logoPositionY, 16, (int)leftSideRecHeight, BLACK);
     }
     else if (state == 2)    // Draw bars animation: bottom and right
     {
-        DrawRectangle(logoPositionX, logoPositionY, topSideRecWidth, 16, BLACK);
-        DrawRectangle(logoPositionX, logoPositionY, 16, leftSideRecHeight, BLACK);
+        DrawRectangle(logoPositionX, logoPositionY, (int)topSideRecWidth, 16, BLACK);
+        DrawRectangle(logoPositionX, logoPositionY, 16, (int)leftSideRecHeight, BLACK);
 
-        DrawRectangle(logoPositionX + 240, logoPositionY, 16, rightSideRecHeight, BLACK);
-        DrawRectangle(logoPositionX, logoPositionY + 240, bottomSideRecWidth, 16, BLACK);
+        DrawRectangle(logoPositionX + 240, logoPositionY, 16, (int)rightSideRecHeight, BLACK);
+        DrawRectangle(logoPositionX, logoPositionY + 240, (int)bottomSideRecWidth, 16, BLACK);
     }
     else if (state == 3)    // Draw "raylib" text-write animation + "powered by"
     {
-        DrawRectangle(logoPositionX, logoPositionY, topSideRecWidth, 16, Fade(BLACK, alpha));
-        DrawRectangle(logoPositionX, logoPositionY + 16, 16, leftSideRecHeight - 32, Fade(BLACK, alpha));
+        DrawRectangle(logoPositionX, logoPositionY, (int)topSideRecWidth, 16, Fade(BLACK, alpha));
+        DrawRectangle(logoPositionX, logoPositionY + 16, 16, (int)leftSideRecHeight - 32, Fade(BLACK, alpha));
 
-        DrawRectangle(logoPositionX + 240, logoPositionY + 16, 16, rightSideRecHeight - 32, Fade(BLACK, alpha));
-        DrawRectangle(logoPositionX, logoPositionY + 240, bottomSideRecWidth, 16, Fade(BLACK, alpha));
+        DrawRectangle(logoPositionX + 240, logoPositionY + 16, 16, (int)rightSideRecHeight - 32, Fade(BLACK, alpha));
+        DrawRectangle(logoPositionX, logoPositionY + 240, (int)bottomSideRecWidth, 16, Fade(BLACK, alpha));
 
         DrawRectangle(GetScreenWidth() / 2 - 112, GetScreenHeight() / 2 - 112, 224, 224, Fade(RAYWHITE, alpha));
 
         DrawText(TextSubtext("raylib", 0, lettersCount), GetScreenWidth() / 2 - 44, GetScreenHeight() / 2 + 48, 50, Fade(BLACK, alpha));
 
-        if (framesCounter > 20) DrawText("powered by", logoPositionX, logoPositionY - 27, 20, Fade(DARKGRAY, alpha));
+        if (timer > LOGO_CREDIT_TIME) DrawText("powered by", logoPositionX, logoPositionY - 27, 20, Fade(DARKGRAY, alpha));
     }
 }
 
@@ -11,6 +11,41 @@
 
 #include "raylib.h"
 #include "screens.h"    // NOTE: Declares global (extern) variables and screens functions
+#include "texture_cache.h"
+#include "asset_prefetch.h"
+#include "asset_pack.h"
+#include "render.h"
+#include "text.h"
+#include "text_cache.h"
+#include "audio.h"
+#include "input.h"
+#include "draw_recorder.h"
+
+#include <time.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Set to 0 to present every gameplay frame, for comparison
+#if !defined(REDRAW_ON_CHANGE)
+#define REDRAW_ON_CHANGE 1
+#endif
+
+#define TARGET_FPS 60
+#if !defined(UPDATE_RATE)
+#define UPDATE_RATE 60          // Fixed updates per second, can be lowered on slow machines
+#endif
+#define MAX_UPDATES_PER_FRAME 5
+#define TRANSITION_FADE_IN 3.0f     // Alpha per second
+#define TRANSITION_FADE_OUT 1.2f
+#define BACKGROUND_FPS 10       // Tick rate while unfocused or minimized
+
+// Set to 2 to draw the gameplay world at half the window resolution, --pixel-scale n and F2
+// switch it too. The ruins art is drawn at 2x and the sprites at 4x, but the forest backgrounds
+// are 1920 pixels wide and lose detail nearest filtered that far down, so it is off by default.
+#if !defined(PIXEL_SCALE)
+#define PIXEL_SCALE 1
+#endif
+#define LOW_RES_PIXEL_SCALE 2   // What F2 switches to from 1
 
 #if defined(PLATFORM_WEB)
 #include <emscripten/emscripten.h>
@@ -23,6 +58,8 @@
 GameScreen currentScreen = 0;
 Font font = { 0 };
 Music music = { 0 };
+float updateStep = 1.0f / UPDATE_RATE;
+float drawAlpha = 0.0f;
 
 //----------------------------------------------------------------------------------
 // Local Variables Definition (local to this module)
@@ -37,6 +74,42 @@ static bool transFadeOut = false;
 static int transFromScreen = -1;
 static int transToScreen = -1;
 
+static bool showDebugInfo = false;     // Toggled with F1, FPS and draw call counters
+
+// Fixed timestep, see UpdateDrawFrame()
+static double updateLag = 0.0;          // Time not simulated yet, less than one step after the updates
+
+// Redraw on change, see UpdateDrawFrame()
+static int frameRate = TARGET_FPS;
+static bool screenDirty = true;         // Frame on screen has more than the gameplay queue in it
+static int presentedFrames = 0;
+static int skippedFrames = 0;
+static bool unthrottled = false;        // --fast, no frame cap and no waits, replays run as quick as they update
+static double frameStart = 0.0;         // GetTime() when the current frame began, skipped frames pace from it
+static int pixelScale = PIXEL_SCALE;    // At startup, see SetRenderView()
+
+// Fill per gameplay frame at the current pixel scale, see TraceFillReport()
+static double fillScreens = 0.0;
+static double trimmedPixels = 0.0;
+static int fillFrames = 0;
+
+// Cold start report, all times in seconds
+typedef struct StartupTimes
+{
+    double window;          // InitWindow(), GetTime() only starts counting inside it
+    double audio;
+    double pack;            // Asset pack mount and sprite atlas table
+    double font;
+    double music;
+    double firstFrame;      // Since process start
+    double titleShown;      // Title screen done fading in, waiting on the player from here
+    double titleWait;
+    double interactive;     // First gameplay scene done fading in, takes input from here
+} StartupTimes;
+
+static StartupTimes startup = { 0 };
+static double startupBase = 0.0;        // GetTime() right after InitWindow()
+
 //----------------------------------------------------------------------------------
 // Local Functions Declaration
 //----------------------------------------------------------------------------------
@@ -46,25 +119,155 @@ static void TransitionToScreen(int screen); // Request transition to next screen
 static void UpdateTransition(void);         // Update transition effect
 static void DrawTransition(void);           // Draw transition effect (full-screen rectangle)
 
+static void UpdateGame(void);               // Update game logic, one fixed step
 static void UpdateDrawFrame(void);          // Update and draw one frame
+static void UpdateFrameRate(void);          // Drop the tick rate while the window is in the background
+static void SkipFrame(void);                // Keep the previous frame on screen, only poll input
+static void TraceFrameReport(void);
+static void TraceFillReport(void);
+
+static void UpdateFrameRate(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (unthrottled) return;
+
+    int wanted = (!IsWindowFocused() || IsWindowMinimized()) ? BACKGROUND_FPS : TARGET_FPS;
+
+    if (wanted != frameRate)
+    {
+        frameRate = wanted;
+        SetTargetFPS(frameRate);
+        screenDirty = true;         // Some compositors drop the window contents on minimize
+    }
+#endif
+}
+
+static void SkipFrame(void)
+{
+    skippedFrames += 1;
+
+    // NOTE: EndDrawing() normally polls input and paces the frame, nothing is swapped here
+    PollInputEvents();
+#if !defined(PLATFORM_WEB)
+    // Only what is left of the frame, updating it took some already
+    double remaining = 1.0 / frameRate - (GetTime() - frameStart);
+    if (!unthrottled && (remaining > 0.0)) WaitTime((float)(remaining * 1000.0));
+#endif
+}
+
+// Log the average fill of the gameplay frames drawn since the last report
+static void TraceFillReport(void)
+{
+    if (fillFrames == 0) return;
+
+    TraceLog(LOG_INFO, "RENDER: Pixel scale %i, %.2f screens filled per gameplay frame over %i frames, %.0f pixels saved by trimmed sprites",
+        GetRenderPixelScale(), fillScreens / fillFrames, fillFrames, trimmedPixels / fillFrames);
+
+    fillScreens = 0.0;
+    trimmedPixels = 0.0;
+    fillFrames = 0;
+}
+
+// Log presented against skipped frames and the CPU time the whole process used meanwhile
+static void TraceFrameReport(void)
+{
+    int frames = presentedFrames + skippedFrames;
+    double cpuSeconds = (double)clock() / CLOCKS_PER_SEC;
+    double wallSeconds = GetTime();
+
+    TraceLog(LOG_INFO, "FRAMES: %i presented, %i skipped (%.0f%%), CPU %.1f%% of one core over %.0f s",
+        presentedFrames, skippedFrames, (frames > 0) ? 100.0 * skippedFrames / frames : 0.0,
+        (wallSeconds > 0.0) ? 100.0 * cpuSeconds / wallSeconds : 0.0, wallSeconds);
+}
+
+static double StartupTime(void);            // Seconds since process start
+static void TraceStartupReport(bool interactive);
 
 //----------------------------------------------------------------------------------
 // Main entry point
 //----------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char* argv[])
 {
     // Initialization
     //---------------------------------------------------------
+    struct timespec processStart = { 0 };
+    timespec_get(&processStart, TIME_UTC);
+
+    // Command line: --record file and --replay file capture a session and play it back,
+    // --fast and --hidden run a replay headless as quick as it goes for soak tests and timings,
+    // --pixel-scale n draws the gameplay world at 1/n of the window resolution
+    const char* recordFile = NULL;
+    const char* replayFile = NULL;
+    unsigned int flags = FLAG_WINDOW_RESIZABLE;     // Gameplay is upscaled by whole steps and letterboxed
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp(argv[i], "--record") == 0) && (i + 1 < argc)) recordFile = argv[++i];
+        else if ((strcmp(argv[i], "--replay") == 0) && (i + 1 < argc)) replayFile = argv[++i];
+        else if (strcmp(argv[i], "--fast") == 0) unthrottled = true;
+        else if (strcmp(argv[i], "--hidden") == 0) flags |= FLAG_WINDOW_HIDDEN;
+        else if ((strcmp(argv[i], "--pixel-scale") == 0) && (i + 1 < argc)) pixelScale = atoi(argv[++i]);
+    }
+
+    SetConfigFlags(flags);
     InitWindow(screenWidth, screenHeight, "Adventure Game Jam 2022");
+    SetWindowMinSize(screenWidth / LOW_RES_PIXEL_SCALE, screenHeight / LOW_RES_PIXEL_SCALE);
+
+    // NOTE: A replay that cannot start would leave a hidden window waiting on nobody
+    bool captured = (replayFile != NULL) ? StartInputReplay(replayFile) : (recordFile != NULL) ? StartInputRecording(recordFile) : true;
+    if (!captured)
+    {
+        CloseWindow();
+        return 1;
+    }
 
+    struct timespec windowReady = { 0 };
+    timespec_get(&windowReady, TIME_UTC);
+    startup.window = (double)(windowReady.tv_sec - processStart.tv_sec) + (windowReady.tv_nsec - processStart.tv_nsec) / 1e9;
+    startupBase = GetTime();
+
+    double phase = GetTime();
     InitAudioDevice();      // Initialize audio device
+    startup.audio = GetTime() - phase;
+
+    // Half size variants of the 1920x1080 art are plenty up to a 960x540 window, on the small
+    // machines those run on keep fewer scenes resident as well
+    if (GetScreenWidth() <= 960 && GetScreenHeight() <= 540)
+    {
+        SetTextureVariant("1x");
+        SetTextureBudget(TEXTURE_BUDGET_BYTES / 4);
+    }
+
+    // Scenes are laid out for the window size we open with whatever it is resized to
+    SetRenderView(screenWidth, screenHeight, pixelScale);
+
+    // Serve data/ from the asset pack when there is one, loose files otherwise
+    phase = GetTime();
+    MountAssetPack("data/assets.pak");
+    LoadSpriteAtlas("data/atlas.txt");      // Sprites fall back to their own textures without it
+    startup.pack = GetTime() - phase;
+
+    // Decode the first gameplay scene on the worker pool while font, music and the LOGO screen
+    // keep the main thread busy, the images wait in RAM until the scene uploads them
+    int imageCount = 0;
+    const char** images = GetGameplayScreenImages(&imageCount);
+    PrefetchImages(images, imageCount);
 
     // Load global data (assets that must be available in all screens, i.e. font)
-    font = LoadFont("data/pixantiqua.png");
-    music = LoadMusicStream("data/tribal.ogg");
+    phase = GetTime();
+    font = LoadGameFont("data/pixantiqua.ttf");   // Falls back to data/pixantiqua.png without SDF
+    LoadTextCache();
+    startup.font = GetTime() - phase;
+
+    phase = GetTime();
+    SetAudioStreamBufferSizeDefault(MUSIC_BUFFER_FRAMES);   // Known size, see GetMusicUnderruns()
+    music = LoadMusicPacked("data/tribal.ogg");
+    startup.music = GetTime() - phase;
 
-    SetMusicVolume(music, 1.0f);
-    PlayMusicStream(music);
+    // NOTE: Music is decoded and refilled on its own thread from now on, see audio.c
+    StartMusicPlayer(music);
+    SetMusicPlayerVolume(1.0f);
+    PlayMusic();
 
     // Setup and init first screen
     currentScreen = LOGO;
@@ -73,16 +276,29 @@ int main(void)
 #if defined(PLATFORM_WEB)
     emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
 #else
-    SetTargetFPS(60);       // Set our game to run at 60 frames-per-second
+    SetTargetFPS(unthrottled ? 0 : TARGET_FPS);     // Set our game to run at 60 frames-per-second
     //--------------------------------------------------------------------------------------
 
     // Main game loop
-    while (!WindowShouldClose())    // Detect window close button or ESC key
+    double loopStart = GetTime();
+    double playSeconds = 0.0;
+
+    while (!WindowShouldClose() && !IsInputReplayDone())    // Detect window close button or ESC key
     {
         UpdateDrawFrame();
+        playSeconds += GetInputFrameTime();
+    }
+
+    if (replayFile != NULL)
+    {
+        double wallSeconds = GetTime() - loopStart;
+        TraceLog(LOG_INFO, "REPLAY: %.1f s of play in %.1f s, %.1fx realtime over %i frames", playSeconds, wallSeconds,
+            (wallSeconds > 0.0) ? playSeconds / wallSeconds : 0.0, presentedFrames + skippedFrames);
     }
 #endif
 
+    StopInputCapture();         // NOTE: Writes out what is left of a recording
+
     // De-Initialization
     //--------------------------------------------------------------------------------------
     // Unload current screen data before closing
@@ -95,9 +311,19 @@ int main(void)
     default: break;
     }
 
+    TraceFrameReport();
+    TraceFillReport();
+
     // Unload global data loaded
-    UnloadFont(font);
+    UnloadPrefetchedImages();
+    UnloadTextureCache();
+    UnloadRenderView();
+    UnloadRenderQueue();
+    UnloadTextCache();
+    UnloadGameFont();
+    StopMusicPlayer();
     UnloadMusicStream(music);
+    UnmountAssetPack();         // NOTE: After music, the stream reads from the mapping
 
     CloseAudioDevice();     // Close audio context
 
@@ -144,6 +370,16 @@ static void TransitionToScreen(int screen)
     transFromScreen = currentScreen;
     transToScreen = screen;
     transAlpha = 0.0f;
+
+    // Decode next screen images while fading in, Init only has to upload them
+    if (screen == GAMEPLAY)
+    {
+        if ((startup.titleShown > 0.0) && (startup.titleWait == 0.0)) startup.titleWait = StartupTime() - startup.titleShown;
+
+        int count = 0;
+        const char** images = GetGameplayScreenImages(&count);
+        PrefetchImages(images, count);
+    }
 }
 
 // Update transition effect (fade-in, fade-out)
@@ -151,7 +387,7 @@ static void UpdateTransition(void)
 {
     if (!transFadeOut)
     {
-        transAlpha += 0.05f;
+        transAlpha += TRANSITION_FADE_IN * updateStep;
 
         // NOTE: Due to float internal representation, condition jumps on 1.0f instead of 1.05f
         // For that reason we compare against 1.01f, to avoid last frame loading stop
@@ -159,6 +395,14 @@ static void UpdateTransition(void)
         {
             transAlpha = 1.0f;
 
+            // Hold on full black until the workers are done, the frame keeps running meanwhile.
+            // Recording or replaying, how many updates that takes must not depend on the disk
+            if ((transToScreen == GAMEPLAY) && IsPrefetchPending())
+            {
+                if (!IsInputCapturing()) return;
+                WaitForPrefetch();
+            }
+
             // Unload current screen
             switch (transFromScreen)
             {
@@ -180,6 +424,10 @@ static void UpdateTransition(void)
             default: break;
             }
 
+            // NOTE: Startup decodes for GAMEPLAY, keep those images through LOGO and TITLE
+            if (transToScreen == GAMEPLAY) UnloadPrefetchedImages();
+            TraceTextureCacheStats("SCREEN");
+
             currentScreen = transToScreen;
 
             // Activate fade out effect to next loaded screen
@@ -188,10 +436,17 @@ static void UpdateTransition(void)
     }
     else  // Transition fade out logic
     {
-        transAlpha -= 0.02f;
+        transAlpha -= TRANSITION_FADE_OUT * updateStep;
 
         if (transAlpha < -0.01f)
         {
+            if ((transToScreen == TITLE) && (startup.titleShown == 0.0)) startup.titleShown = StartupTime();
+            else if ((transToScreen == GAMEPLAY) && (startup.interactive == 0.0))
+            {
+                startup.interactive = StartupTime();
+                TraceStartupReport(true);
+            }
+
             transAlpha = 0.0f;
             transFadeOut = false;
             onTransition = false;
@@ -204,16 +459,12 @@ static void UpdateTransition(void)
 // Draw transition effect (full-screen rectangle)
 static void DrawTransition(void)
 {
-    DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), Fade(BLACK, transAlpha));
+    DrawPanel(0, 0, GetScreenWidth(), GetScreenHeight(), Fade(BLACK, transAlpha));
 }
 
-// Update and draw game frame
-static void UpdateDrawFrame(void)
+// Update game logic, one fixed step
+static void UpdateGame(void)
 {
-    // Update
-    //----------------------------------------------------------------------------------
-    UpdateMusicStream(music);       // NOTE: Music keeps playing between screens
-
     if (!onTransition)
     {
         switch (currentScreen)
@@ -259,29 +510,171 @@ static void UpdateDrawFrame(void)
         }
     }
     else UpdateTransition();    // Update transition (fade-in, fade-out)
+}
+
+// Update and draw game frame
+static void UpdateDrawFrame(void)
+{
+    frameStart = GetTime();
+
+    // Update
+    //----------------------------------------------------------------------------------
+    UpdateMusicPlayer();            // NOTE: Music keeps playing between screens, on its own thread where possible
+
+    if (IsKeyPressed(KEY_F1)) showDebugInfo = !showDebugInfo;
+
+    if (IsKeyPressed(KEY_F2))
+    {
+        TraceFillReport();
+        SetRenderView(screenWidth, screenHeight, (GetRenderPixelScale() > 1) ? 1 : LOW_RES_PIXEL_SCALE);
+        screenDirty = true;
+    }
+
+    UpdateFrameRate();
+
+    UpdateTextureCache();           // Evict down to the texture budget, before anything draws
+
+    // Glyphs first used last frame join the font atlas before anything draws with it
+    if (UpdateGameFont()) font = GetGameFont();
+    UpdateTextCache();              // Strings missed last frame are drawn as one quad from now on
+
+    // Fixed timestep: the game updates UPDATE_RATE times per second whatever the refresh
+    // rate, drawing interpolates between the last two updates
+    // NOTE: Frame time comes through input as well, a replay steps exactly like its recording
+    UpdateInput();
+    updateLag += GetInputFrameTime();
+
+    // After a stall (scene load, window drag) drop the backlog instead of racing through it
+    if (updateLag > MAX_UPDATES_PER_FRAME * updateStep) updateLag = MAX_UPDATES_PER_FRAME * updateStep;
+
+    while (updateLag >= updateStep)
+    {
+        UpdateGame();
+        ConsumeInput();
+        updateLag -= updateStep;
+    }
+
+    drawAlpha = (float)(updateLag / updateStep);
     //----------------------------------------------------------------------------------
 
     // Draw
     //----------------------------------------------------------------------------------
+    ResetDrawStats();
+
+    // Gameplay only submits, nothing is drawn until the queue is flushed. When it queued
+    // exactly what is on screen already (idle, nothing hovered, no animation frame advanced)
+    // that frame is presented again instead of redrawing it
+    bool submitted = false;
+#if REDRAW_ON_CHANGE
+    if ((currentScreen == GAMEPLAY) && !onTransition && !showDebugInfo && !screenDirty && !IsWindowResized())
+    {
+        DrawGameplayScreen();
+        submitted = true;
+
+        if (!HasRenderQueueChanged())
+        {
+            DiscardRenderQueue();
+            SkipFrame();
+            return;
+        }
+    }
+#endif
+
     BeginDrawing();
 
+#if defined(DRAW_RECORDER)
+    BeginRecordedFrame();
+#endif
+
     ClearBackground(RAYWHITE);
 
-    switch (currentScreen)
+    if (!submitted)
     {
-    case LOGO: DrawLogoScreen(); break;
-    case TITLE: DrawTitleScreen(); break;
-    case OPTIONS: DrawOptionsScreen(); break;
-    case GAMEPLAY: DrawGameplayScreen(); break;
-    case ENDING: DrawEndingScreen(); break;
-    default: break;
+        switch (currentScreen)
+        {
+        case LOGO: DrawLogoScreen(); break;
+        case TITLE: DrawTitleScreen(); break;
+        case OPTIONS: DrawOptionsScreen(); break;
+        case GAMEPLAY: DrawGameplayScreen(); break;
+        case ENDING: DrawEndingScreen(); break;
+        default: break;
+        }
+    }
+
+    FlushRenderQueue();             // Scenes submit sprites, grouped by layer and texture here
+
+    if (currentScreen == GAMEPLAY)
+    {
+        DrawStats stats = GetDrawStats();
+        fillScreens += (double)stats.pixels / (GetScreenWidth() * GetScreenHeight());
+        trimmedPixels += stats.trimmedPixels;
+        fillFrames += 1;
     }
 
     // Draw full screen rectangle in front of everything
     if (onTransition) DrawTransition();
 
-    //DrawFPS(10, 10);
+#if defined(DRAW_RECORDER)
+    // Everything but the overlay went to the command list, it reaches the screen through replay
+    EndRecordedFrame();
+    ReplayDrawFrame(GetRecordedFrame());
+#endif
+
+    if (showDebugInfo)
+    {
+        DrawStats stats = GetDrawStats();
+        DrawFPS(10, 10);
+        DrawText(TextFormat("draw calls: %i (%i unsorted)  texture switches: %i  shader switches: %i  quads: %i  vertices: %i", stats.drawCalls,
+            stats.submittedDrawCalls, stats.textureSwitches, stats.shaderSwitches, stats.quads, stats.vertices), 10, 30, 10, LIME);
+        DrawText(TextFormat("frame: %.2f ms  fill: %.2f screens at pixel scale %i  trimmed: %i pixels  culled: %i", GetInputFrameTime() * 1000.0,
+            (float)stats.pixels / (GetScreenWidth() * GetScreenHeight()), GetRenderPixelScale(), stats.trimmedPixels, stats.culled), 10, 42, 10, LIME);
+        DrawText(TextFormat("music underruns: %i", GetMusicUnderruns()), 10, 54, 10, LIME);
+
+        TextureCacheStats textures = GetTextureCacheStats();
+        DrawText(TextFormat("textures: %i resident, %.1f of %.1f MB", textures.residentTextures,
+            textures.residentBytes / (1024.0f * 1024.0f), textures.budgetBytes / (1024.0f * 1024.0f)), 10, 66, 10, LIME);
+
+        TextCacheStats texts = GetTextCacheStats();
+        DrawText(TextFormat("text cache: %i strings, %i hits, %i misses, %i evicted", texts.cachedTexts, texts.hits,
+            texts.misses, texts.evicted), 10, 78, 10, LIME);
+    }
 
     EndDrawing();
     //----------------------------------------------------------------------------------
+
+    presentedFrames += 1;
+    screenDirty = (currentScreen != GAMEPLAY) || onTransition || showDebugInfo;
+
+    if (startup.firstFrame == 0.0)
+    {
+        startup.firstFrame = StartupTime();
+        TraceStartupReport(false);
+    }
+}
+
+static double StartupTime(void)
+{
+    return startup.window + (GetTime() - startupBase);
+}
+
+// Log where cold start time went, first at the first frame and again once gameplay takes input
+static void TraceStartupReport(bool interactive)
+{
+    if (!interactive)
+    {
+        TraceLog(LOG_INFO, "STARTUP: First frame at %.0f ms (window %.0f, audio %.0f, pack %.0f, font %.0f, music %.0f ms)",
+            startup.firstFrame * 1000.0, startup.window * 1000.0, startup.audio * 1000.0, startup.pack * 1000.0,
+            startup.font * 1000.0, startup.music * 1000.0);
+        return;
+    }
+
+    PrefetchStats prefetch = GetPrefetchStats();
+    TextureCacheStats textures = GetTextureCacheStats();
+
+    TraceLog(LOG_INFO, "STARTUP: Interactive at %.0f ms, %.0f ms of that waiting on the title screen",
+        startup.interactive * 1000.0, startup.titleWait * 1000.0);
+    TraceLog(LOG_INFO, "STARTUP:     workers: %i images on %i threads, file i/o %.0f ms + decode %.0f ms in %.0f ms wall",
+        prefetch.images, prefetch.workers, prefetch.ioSeconds * 1000.0, prefetch.decodeSeconds * 1000.0, prefetch.wallSeconds * 1000.0);
+    TraceLog(LOG_INFO, "STARTUP:     main thread: upload %.0f ms, load on cache miss %.0f ms",
+        textures.uploadSeconds * 1000.0, textures.loadSeconds * 1000.0);
 }
@@ -0,0 +1,437 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Navigation: the player used to walk straight at the click, kept on the floor by a fixed
+*   minimum y. Scenes now give a floor polygon and blockers, rasterised into a grid at load.
+*   A click runs A* over the grid and keeps only the corners a straight line cannot skip.
+*   Paths are cached by start and goal cell, clicking around the same spots costs a lookup.
+*
+*   NOTE: Positions are where the feet are, the cells know nothing about sprite sizes
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "navigation.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SQRT2 1.41421356f
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//---------------------------------------------------------------------------------
+// Straight steps first, a diagonal needs both straight steps beside it free
+static const int stepX[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+static const int stepY[8] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+// Even-odd rule, points on an edge may fall either way
+static bool IsInsidePolygon(Vector2 point, const Vector2* polygon, int count)
+{
+    bool inside = false;
+
+    for (int i = 0, j = count - 1; i < count; j = i++)
+    {
+        Vector2 a = polygon[i];
+        Vector2 b = polygon[j];
+
+        if (((a.y > point.y) != (b.y > point.y)) && (point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x)) inside = !inside;
+    }
+
+    return inside;
+}
+
+static bool IsWalkable(const NavMesh* mesh, int column, int row)
+{
+    if ((column < 0) || (row < 0) || (column >= mesh->columns) || (row >= mesh->rows)) return false;
+
+    return mesh->walkable[row * mesh->columns + column];
+}
+
+static Vector2 CellCenter(const NavMesh* mesh, int cell)
+{
+    return (Vector2){ mesh->area.x + (cell % mesh->columns + 0.5f) * mesh->cellSize, mesh->area.y + (cell / mesh->columns + 0.5f) * mesh->cellSize };
+}
+
+// Octile distance in cells, exact on an empty floor. Nudged up a little so that of the many
+// equally short paths the search follows one instead of opening them all.
+static float Heuristic(const NavMesh* mesh, int cell, int goal)
+{
+    int dx = abs(cell % mesh->columns - goal % mesh->columns);
+    int dy = abs(cell / mesh->columns - goal / mesh->columns);
+
+    return ((dx + dy) + (SQRT2 - 2.0f) * ((dx < dy) ? dx : dy)) * 1.001f;
+}
+
+// Walkable cell closest to point, the one under it when there is one
+static int NearestCell(const NavMesh* mesh, Vector2 point)
+{
+    int column = (int)floorf((point.x - mesh->area.x) / mesh->cellSize);
+    int row = (int)floorf((point.y - mesh->area.y) / mesh->cellSize);
+
+    if (IsWalkable(mesh, column, row)) return row * mesh->columns + column;
+
+    column = (column < 0) ? 0 : (column >= mesh->columns) ? mesh->columns - 1 : column;
+    row = (row < 0) ? 0 : (row >= mesh->rows) ? mesh->rows - 1 : row;
+
+    // Rings around the clamped cell, the first ring with a walkable cell has the nearest
+    int radiusLimit = (mesh->columns > mesh->rows) ? mesh->columns : mesh->rows;
+
+    for (int radius = 0; radius <= radiusLimit; ++radius)
+    {
+        int best = -1;
+        float bestDistance = 0.0f;
+
+        for (int y = row - radius; y <= row + radius; ++y)
+        {
+            for (int x = column - radius; x <= column + radius; ++x)
+            {
+                bool edge = (y == row - radius) || (y == row + radius) || (x == column - radius) || (x == column + radius);
+                if (!edge || !IsWalkable(mesh, x, y)) continue;
+
+                Vector2 center = CellCenter(mesh, y * mesh->columns + x);
+                float distance = (center.x - point.x) * (center.x - point.x) + (center.y - point.y) * (center.y - point.y);
+
+                if ((best == -1) || (distance < bestDistance))
+                {
+                    best = y * mesh->columns + x;
+                    bestDistance = distance;
+                }
+            }
+        }
+
+        if (best != -1) return best;
+    }
+
+    return -1;
+}
+
+// Every cell the line between two cell centers passes through is walkable, a line through a
+// corner needs both cells beside it
+static bool IsClearLine(const NavMesh* mesh, int from, int to)
+{
+    int x = from % mesh->columns;
+    int y = from / mesh->columns;
+    int dx = abs(to % mesh->columns - x);
+    int dy = abs(to / mesh->columns - y);
+    int sx = (to % mesh->columns > x) ? 1 : -1;
+    int sy = (to / mesh->columns > y) ? 1 : -1;
+
+    for (int ix = 0, iy = 0; (ix < dx) || (iy < dy);)
+    {
+        int decision = (1 + 2 * ix) * dy - (1 + 2 * iy) * dx;
+
+        if (decision == 0)
+        {
+            if (!IsWalkable(mesh, x + sx, y) || !IsWalkable(mesh, x, y + sy)) return false;
+
+            x += sx;
+            y += sy;
+            ix += 1;
+            iy += 1;
+        }
+        else if (decision < 0)
+        {
+            x += sx;
+            ix += 1;
+        }
+        else
+        {
+            y += sy;
+            iy += 1;
+        }
+
+        if (!IsWalkable(mesh, x, y)) return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Open list, a binary heap on estimate that knows where each cell sits in it
+//----------------------------------------------------------------------------------
+static void HeapSwap(NavMesh* mesh, int a, int b)
+{
+    int cell = mesh->heap[a];
+    mesh->heap[a] = mesh->heap[b];
+    mesh->heap[b] = cell;
+    mesh->heapIndex[mesh->heap[a]] = a;
+    mesh->heapIndex[mesh->heap[b]] = b;
+}
+
+static void HeapUp(NavMesh* mesh, int index)
+{
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (mesh->estimate[mesh->heap[parent]] <= mesh->estimate[mesh->heap[index]]) break;
+
+        HeapSwap(mesh, parent, index);
+        index = parent;
+    }
+}
+
+static int HeapPop(NavMesh* mesh, int* count)
+{
+    int top = mesh->heap[0];
+
+    *count -= 1;
+    HeapSwap(mesh, 0, *count);
+
+    for (int index = 0;;)
+    {
+        int smallest = index;
+        int left = index * 2 + 1;
+        int right = left + 1;
+
+        if ((left < *count) && (mesh->estimate[mesh->heap[left]] < mesh->estimate[mesh->heap[smallest]])) smallest = left;
+        if ((right < *count) && (mesh->estimate[mesh->heap[right]] < mesh->estimate[mesh->heap[smallest]])) smallest = right;
+        if (smallest == index) break;
+
+        HeapSwap(mesh, index, smallest);
+        index = smallest;
+    }
+
+    return top;
+}
+
+// A* from cell to cell, fills corners and returns how many, -1 when goal cannot be reached
+static int SearchPath(NavMesh* mesh, int start, int goal, int* corners)
+{
+    unsigned int search = ++mesh->search;
+    int heapCount = 0;
+
+    mesh->searches += 1;
+
+    mesh->seen[start] = search;
+    mesh->cost[start] = 0.0f;
+    mesh->estimate[start] = Heuristic(mesh, start, goal);
+    mesh->parent[start] = -1;
+    mesh->heap[0] = start;
+    mesh->heapIndex[start] = 0;
+    heapCount = 1;
+
+    while (heapCount > 0)
+    {
+        int cell = HeapPop(mesh, &heapCount);
+        mesh->closed[cell] = search;
+        if (cell == goal) break;
+
+        for (int direction = 0; direction < 8; ++direction)
+        {
+            if ((mesh->links[cell] & (1 << direction)) == 0) continue;
+
+            int next = cell + stepY[direction] * mesh->columns + stepX[direction];
+            if (mesh->closed[next] == search) continue;
+
+            float cost = mesh->cost[cell] + ((direction < 4) ? 1.0f : SQRT2);
+
+            if (mesh->seen[next] != search)
+            {
+                mesh->seen[next] = search;
+                mesh->cost[next] = cost;
+                mesh->estimate[next] = cost + Heuristic(mesh, next, goal);
+                mesh->parent[next] = cell;
+                mesh->heap[heapCount] = next;
+                mesh->heapIndex[next] = heapCount;
+                heapCount += 1;
+                HeapUp(mesh, heapCount - 1);
+            }
+            else if (cost < mesh->cost[next])
+            {
+                mesh->estimate[next] -= mesh->cost[next] - cost;
+                mesh->cost[next] = cost;
+                mesh->parent[next] = cell;
+                HeapUp(mesh, mesh->heapIndex[next]);
+            }
+        }
+    }
+
+    if (mesh->closed[goal] != search) return -1;
+
+    // The heap is free now, it holds the cells from goal back to start
+    int* trail = mesh->heap;
+    int length = 0;
+    for (int cell = goal; cell != -1; cell = mesh->parent[cell]) trail[length++] = cell;
+
+    // From each corner, head as far along the trail as a straight line goes. Strides double
+    // and then halve, a long straight walk takes a handful of line tests instead of one per cell.
+    int count = 0;
+    int anchor = length - 1;
+
+    while (anchor > 0)
+    {
+        int next = anchor - 1;
+        int stride = 1;
+
+        while ((next - stride >= 0) && IsClearLine(mesh, trail[anchor], trail[next - stride]))
+        {
+            next -= stride;
+            stride *= 2;
+        }
+
+        while (stride > 1)
+        {
+            stride /= 2;
+            if ((next - stride >= 0) && IsClearLine(mesh, trail[anchor], trail[next - stride])) next -= stride;
+        }
+
+        if (count == MAX_NAV_PATH)
+        {
+            TraceLog(LOG_WARNING, "NAVIGATION: Path with more than %i corners dropped", MAX_NAV_PATH);
+            return -1;
+        }
+
+        corners[count++] = trail[next];
+        anchor = next;
+    }
+
+    return count;
+}
+
+//----------------------------------------------------------------------------------
+// Navigation Functions Definition
+//----------------------------------------------------------------------------------
+void LoadNavMesh(NavMesh* mesh, const Vector2* floor, int pointCount, const Rectangle* blockers, int blockerCount, float cellSize)
+{
+    UnloadNavMesh(mesh);
+
+    if (pointCount < 3) return;
+
+    Vector2 low = floor[0];
+    Vector2 high = floor[0];
+    for (int i = 1; i < pointCount; ++i)
+    {
+        low = (Vector2){ fminf(low.x, floor[i].x), fminf(low.y, floor[i].y) };
+        high = (Vector2){ fmaxf(high.x, floor[i].x), fmaxf(high.y, floor[i].y) };
+    }
+
+    mesh->area = (Rectangle){ low.x, low.y, high.x - low.x, high.y - low.y };
+    mesh->cellSize = cellSize;
+    while ((ceilf(mesh->area.width / mesh->cellSize) * ceilf(mesh->area.height / mesh->cellSize)) > MAX_NAV_CELLS) mesh->cellSize *= 2.0f;
+
+    mesh->columns = (int)fmaxf(ceilf(mesh->area.width / mesh->cellSize), 1.0f);
+    mesh->rows = (int)fmaxf(ceilf(mesh->area.height / mesh->cellSize), 1.0f);
+
+    int cells = mesh->columns * mesh->rows;
+    mesh->walkable = (bool*)MemAlloc(cells * sizeof(bool));
+    mesh->links = (unsigned char*)MemAlloc(cells);
+    mesh->cost = (float*)MemAlloc(cells * sizeof(float));
+    mesh->estimate = (float*)MemAlloc(cells * sizeof(float));
+    mesh->parent = (int*)MemAlloc(cells * sizeof(int));
+    mesh->seen = (unsigned int*)MemAlloc(cells * sizeof(unsigned int));
+    mesh->closed = (unsigned int*)MemAlloc(cells * sizeof(unsigned int));
+    mesh->heap = (int*)MemAlloc(cells * sizeof(int));
+    mesh->heapIndex = (int*)MemAlloc(cells * sizeof(int));
+    mesh->cache = (NavCachedPath*)MemAlloc(NAV_PATH_CACHE * sizeof(NavCachedPath));
+
+    memset(mesh->seen, 0, cells * sizeof(unsigned int));
+    memset(mesh->closed, 0, cells * sizeof(unsigned int));
+    for (int i = 0; i < NAV_PATH_CACHE; ++i) mesh->cache[i] = (NavCachedPath){ .start = -1 };
+
+    // A cell is floor when its center is
+    for (int cell = 0; cell < cells; ++cell)
+    {
+        Vector2 center = CellCenter(mesh, cell);
+        bool walkable = IsInsidePolygon(center, floor, pointCount);
+
+        for (int i = 0; walkable && (i < blockerCount); ++i)
+        {
+            if (CheckCollisionPointRec(center, blockers[i])) walkable = false;
+        }
+
+        mesh->walkable[cell] = walkable;
+    }
+
+    for (int cell = 0; cell < cells; ++cell)
+    {
+        int column = cell % mesh->columns;
+        int row = cell / mesh->columns;
+        unsigned char links = 0;
+
+        for (int direction = 0; mesh->walkable[cell] && (direction < 8); ++direction)
+        {
+            int x = column + stepX[direction];
+            int y = row + stepY[direction];
+
+            // No cutting corners past a blocker
+            bool clear = IsWalkable(mesh, x, y) && IsWalkable(mesh, x, row) && IsWalkable(mesh, column, y);
+            if (clear) links |= (unsigned char)(1 << direction);
+        }
+
+        mesh->links[cell] = links;
+    }
+}
+
+void UnloadNavMesh(NavMesh* mesh)
+{
+    MemFree(mesh->walkable);
+    MemFree(mesh->links);
+    MemFree(mesh->cost);
+    MemFree(mesh->estimate);
+    MemFree(mesh->parent);
+    MemFree(mesh->seen);
+    MemFree(mesh->closed);
+    MemFree(mesh->heap);
+    MemFree(mesh->heapIndex);
+    MemFree(mesh->cache);
+    *mesh = (NavMesh){ 0 };
+}
+
+bool FindNavPath(NavMesh* mesh, Vector2 start, Vector2 goal, NavPath* path)
+{
+    path->count = 0;
+    if (mesh->walkable == NULL) return false;
+
+    int startCell = NearestCell(mesh, start);
+    int goalCell = NearestCell(mesh, goal);
+    if ((startCell == -1) || (goalCell == -1)) return false;
+
+    // A few ways per set, the least recently used of them makes room
+    unsigned int hash = (unsigned int)startCell * 2654435761u ^ (unsigned int)goalCell * 2246822519u;
+    NavCachedPath* set = &mesh->cache[((hash ^ (hash >> 15)) & (NAV_PATH_CACHE / NAV_PATH_WAYS - 1)) * NAV_PATH_WAYS];
+    NavCachedPath* entry = NULL;
+    NavCachedPath* oldest = &set[0];
+
+    for (int way = 0; way < NAV_PATH_WAYS; ++way)
+    {
+        if ((set[way].start == startCell) && (set[way].goal == goalCell)) entry = &set[way];
+        if (set[way].lastUsed < oldest->lastUsed) oldest = &set[way];
+    }
+
+    if (entry != NULL) mesh->cacheHits += 1;
+    else
+    {
+        entry = oldest;
+        entry->start = startCell;
+        entry->goal = goalCell;
+        entry->count = SearchPath(mesh, startCell, goalCell, entry->corners);
+    }
+
+    entry->lastUsed = ++mesh->lookups;
+
+    if (entry->count < 0) return false;
+
+    // Corners at cell centers, the walk ends at the goal itself or the closest floor to it
+    for (int i = 0; i < entry->count - 1; ++i) path->points[path->count++] = CellCenter(mesh, entry->corners[i]);
+
+    Vector2 corner = CellCenter(mesh, goalCell);
+    float half = mesh->cellSize / 2 - 0.01f;
+    path->points[path->count++] = (Vector2){ fminf(fmaxf(goal.x, corner.x - half), corner.x + half), fminf(fmaxf(goal.y, corner.y - half), corner.y + half) };
+
+    return true;
+}
+
+bool IsOnNavMesh(const NavMesh* mesh, Vector2 point)
+{
+    if (mesh->walkable == NULL) return false;
+
+    return IsWalkable(mesh, (int)floorf((point.x - mesh->area.x) / mesh->cellSize), (int)floorf((point.y - mesh->area.y) / mesh->cellSize));
+}
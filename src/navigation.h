@@ -0,0 +1,74 @@
+#ifndef NAVIGATION_H
+#define NAVIGATION_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define NAV_CELL_SIZE 16				// Scene pixels, small enough to walk between props
+#define MAX_NAV_CELLS 262144			// Cells grow past NAV_CELL_SIZE for larger floors
+#define MAX_NAV_PATH 32					// Corners of one path, the goal included
+#define NAV_PATH_CACHE 256				// Paths remembered per mesh, a power of two
+#define NAV_PATH_WAYS 4					// Paths sharing a set, a power of two as well
+
+// Walking route, corners to head for in order, the last one is where the walk ends
+typedef struct NavPath
+{
+	int count;
+	Vector2 points[MAX_NAV_PATH];
+} NavPath;
+
+typedef struct NavCachedPath
+{
+	int start;				// Cells, -1 for an unused entry
+	int goal;
+	int count;				// -1 when the goal cannot be reached from start
+	unsigned int lastUsed;
+	int corners[MAX_NAV_PATH];
+} NavCachedPath;
+
+// Floor polygon less the blockers, rasterised into cells once at scene load. Every walkable
+// cell links to the neighbours it can step to, so a search only reads the links.
+typedef struct NavMesh
+{
+	Rectangle area;			// Bounds of the floor, the cells cover exactly this
+	float cellSize;
+	int columns;
+	int rows;
+	unsigned char* links;	// Per cell, a bit per direction it can step in, 0 when not walkable
+	bool* walkable;
+
+	// Search scratch, sized once, stamped per search instead of cleared
+	float* cost;			// Steps from the start, in cells
+	float* estimate;		// Cost plus the straight line left to the goal
+	int* parent;
+	unsigned int* seen;
+	unsigned int* closed;
+	int* heap;
+	int* heapIndex;
+	unsigned int search;
+
+	NavCachedPath* cache;	// Set associative, NAV_PATH_WAYS entries per set
+	unsigned int lookups;
+	int searches;			// A* runs, the rest were cache hits
+	int cacheHits;
+} NavMesh;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Navigation Functions Declaration
+	//----------------------------------------------------------------------------------
+	void LoadNavMesh(NavMesh* mesh, const Vector2* floor, int pointCount, const Rectangle* blockers, int blockerCount, float cellSize);
+	void UnloadNavMesh(NavMesh* mesh);
+	bool FindNavPath(NavMesh* mesh, Vector2 start, Vector2 goal, NavPath* path);	// Goal off the floor walks to the nearest floor
+	bool IsOnNavMesh(const NavMesh* mesh, Vector2 point);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NAVIGATION_H
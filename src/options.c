@@ -25,6 +25,7 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "draw_recorder.h"      // Draw calls are captured instead with DRAW_RECORDER defined
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
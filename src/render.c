@@ -0,0 +1,787 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Render: thin layer over the raylib draw calls used by the scenes. It keeps track of
+*   texture changes, which is what makes raylib flush its internal batch, so every frame
+*   reports how many draw calls it actually cost.
+*
+*   Scenes submit instead of drawing in code order. When flushed the queue is sorted by layer,
+*   then inside a layer each item moves back to the last one sharing its texture, so a texture
+*   is bound once per run instead of once per alternation (atlas, font, shapes, atlas...).
+*   An item never moves past one it overlaps, what covers what stays in submit order.
+*
+*   World layers are drawn through a Camera2D so scenes can be wider than the window. Scenes
+*   test their cached bounds with IsInRenderView() and skip submitting what is off screen.
+*
+*   The art is drawn at 2x and 4x its own pixels, so with a render view and a pixel scale the
+*   world layers can go to a render texture at art resolution instead, upscaled once nearest
+*   filtered. World text stays at window resolution, glyphs do not survive that. Window sizes
+*   that are not a whole multiple of the view are letterboxed, the mouse is mapped back.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "render.h"
+#include "text.h"
+#include "text_cache.h"
+#include "draw_recorder.h"      // Draw calls are captured instead with DRAW_RECORDER defined
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Shapes are drawn with raylib's default white texture, never a texture we loaded
+#define SHAPES_TEXTURE_ID 0
+
+// Layers below this one are in scene coordinates
+#define FIRST_SCREEN_LAYER RENDER_UI_PANELS
+
+#define RENDER_BLEND_ONE 1                      // GL_ONE, rlSetBlendFactors() takes raw GL values
+#define RENDER_BLEND_ONE_MINUS_DST_ALPHA 0x0305 // GL_ONE_MINUS_DST_ALPHA
+#define RENDER_BLEND_ADD 0x8006                 // GL_FUNC_ADD
+
+// NOTE: From rlgl.h, which include/ does not ship, the function is exported by raylib itself
+void rlSetBlendFactors(int glSrcFactor, int glDstFactor, int glEquation);
+
+typedef enum RenderItemType { ITEM_TEXTURE = 0, ITEM_LABEL, ITEM_PANEL } RenderItemType;
+
+typedef struct RenderItem
+{
+    RenderItemType type;
+    RenderLayer layer;
+    int order;                  // Submit order, keeps the sort stable
+    Texture2D texture;          // Font atlas for labels, none for panels
+    Rectangle source;
+    Rectangle dest;             // Label position in x and y
+    Color tint;
+    const char* text;           // Labels drawn now, queued ones copy it to textOffset
+    int textOffset;
+    float fontSize;
+    float spacing;
+} RenderItem;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//---------------------------------------------------------------------------------
+static DrawStats stats = { 0 };
+static unsigned int boundTexture = SHAPES_TEXTURE_ID;
+static bool anyDrawn = false;
+static unsigned int submitTexture = SHAPES_TEXTURE_ID;
+static bool anySubmitted = false;
+
+// Both grow when a frame submits more, nothing is ever drawn out of order
+static RenderItem* queue = NULL;
+static int queueCount = 0;
+static int queueCapacity = 0;
+static char* textBuffer = NULL;
+static int textUsed = 0;
+static int textCapacity = 0;
+static unsigned int flushedHash = 0;    // Queue contents last drawn, see HasRenderQueueChanged()
+
+static Camera2D camera = { 0 };         // Scene to view, as the scene set it
+static bool hasCamera = false;          // Cleared on flush, screens without a scene draw as is
+static Camera2D drawCamera = { 0 };     // What BeginMode2D() was given, stats convert with it
+static bool drawingCamera = false;
+static Vector2 framebuffer = { 0 };     // Size of what is drawn to, fill is clipped to it
+
+// Render view, see SetRenderView()
+static int viewWidth = 0;               // 0 follows the window
+static int viewHeight = 0;
+static int pixelScale = 1;
+static RenderTexture2D lowRes = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+// Count a batch whenever the texture changes, that is when raylib flushes
+static bool CountBatch(unsigned int textureId, unsigned int* bound, bool* any, int* batches)
+{
+    bool switched = *any && (textureId != *bound);
+
+    if (!*any || switched) *batches += 1;
+
+    *bound = textureId;
+    *any = true;
+    return switched;
+}
+
+static Rectangle CameraToScreen(Rectangle rect)
+{
+    Vector2 topLeft = GetWorldToScreen2D((Vector2){ rect.x, rect.y }, drawCamera);
+    Vector2 bottomRight = GetWorldToScreen2D((Vector2){ rect.x + rect.width, rect.y + rect.height }, drawCamera);
+    return (Rectangle){ topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y };
+}
+
+static void TrackDraw(unsigned int textureId, int quads, Rectangle dest)
+{
+    if (drawingCamera) dest = CameraToScreen(dest);
+
+    Rectangle screen = { 0, 0, framebuffer.x, framebuffer.y };
+    Rectangle visible = GetCollisionRec(screen, dest);
+    stats.pixels += (int)(visible.width * visible.height);
+
+    if (CountBatch(textureId, &boundTexture, &anyDrawn, &stats.drawCalls)) stats.textureSwitches += 1;
+
+    stats.quads += quads;
+    stats.vertices += quads * 4;
+}
+
+// Trimmed sheets hold only the opaque part of each frame, draw that part where it sits in the
+// frame. A source spanning several frames is clipped to the first one.
+static bool TrimSprite(Sprite sprite, Rectangle* source, Rectangle* dest)
+{
+    bool flipped = (source->width < 0);
+    float width = fabsf(source->width);
+    int index = (int)(source->x / sprite.frameSize.x);
+    float area = dest->width * dest->height;
+
+    Rectangle kept = { 0 };
+    const SpriteTrim* trim = NULL;
+    Rectangle wanted = { source->x - index * sprite.frameSize.x, source->y, width, source->height };
+
+    if ((index >= 0) && (index < sprite.frameCount))
+    {
+        trim = &sprite.trims[index];
+        kept = GetCollisionRec(wanted, (Rectangle){ trim->offset.x, trim->offset.y, trim->region.width, trim->region.height });
+    }
+
+    if ((kept.width <= 0) || (kept.height <= 0))
+    {
+        stats.trimmedPixels += (int)area;
+        return false;
+    }
+
+    float scaleX = dest->width / width;
+    float scaleY = dest->height / source->height;
+    float left = flipped ? (wanted.x + wanted.width) - (kept.x + kept.width) : kept.x - wanted.x;
+
+    *dest = (Rectangle){ dest->x + left * scaleX, dest->y + (kept.y - wanted.y) * scaleY, kept.width * scaleX, kept.height * scaleY };
+    *source = (Rectangle){ trim->region.x + kept.x - trim->offset.x, trim->region.y + kept.y - trim->offset.y,
+        flipped ? -kept.width : kept.width, kept.height };
+
+    stats.trimmedPixels += (int)(area - dest->width * dest->height);
+    return true;
+}
+
+// False when nothing of the sprite is left to draw
+static bool SpriteItem(Sprite sprite, Rectangle source, Rectangle dest, Color tint, RenderItem* item)
+{
+    if (sprite.trims != NULL)
+    {
+        if (!TrimSprite(sprite, &source, &dest)) return false;
+    }
+    else
+    {
+        source.x = sprite.region.x + source.x * sprite.scale;
+        source.y = sprite.region.y + source.y * sprite.scale;
+        source.width *= sprite.scale;
+        source.height *= sprite.scale;
+    }
+
+    *item = (RenderItem){ .type = ITEM_TEXTURE, .texture = UseTexture(sprite.texture), .source = source, .dest = dest, .tint = tint };
+    return true;
+}
+
+static RenderItem LayerItem(TextureHandle layer, Vector2 position, float scale, Color tint)
+{
+    Texture2D texture = UseTexture(layer);
+    scale /= GetTextureScale(layer);
+
+    Rectangle source = { 0, 0, (float)texture.width, (float)texture.height };
+    Rectangle dest = { position.x, position.y, texture.width * scale, texture.height * scale };
+    return (RenderItem){ .type = ITEM_TEXTURE, .texture = texture, .source = source, .dest = dest, .tint = tint };
+}
+
+static RenderItem TargetItem(RenderTexture2D target, Rectangle dest, Color tint)
+{
+    Texture2D texture = target.texture;
+
+    // NOTE: Render textures are stored upside down, hence the negative source height
+    Rectangle source = { 0, 0, (float)texture.width, -(float)texture.height };
+    return (RenderItem){ .type = ITEM_TEXTURE, .texture = texture, .source = source, .dest = dest, .tint = tint };
+}
+
+static RenderItem LabelItem(const char* text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    // Cached strings are a single quad, the rest is laid out glyph by glyph when drawn
+    Texture2D texture = { 0 };
+    Rectangle source = { 0 };
+    Vector2 offset = { 0 };
+
+    if (FindCachedText(text, fontSize, spacing, tint, &texture, &source, &offset))
+    {
+        Rectangle dest = { position.x + offset.x, position.y + offset.y, source.width, -source.height };
+        return (RenderItem){ .type = ITEM_TEXTURE, .texture = texture, .source = source, .dest = dest, .tint = WHITE };
+    }
+
+    Vector2 size = MeasureGameText(text, fontSize, spacing);
+    return (RenderItem){ .type = ITEM_LABEL, .texture = GetGameFont().texture, .dest = { position.x, position.y, size.x, size.y },
+        .tint = tint, .text = text, .fontSize = fontSize, .spacing = spacing };
+}
+
+static RenderItem PanelItem(int posX, int posY, int width, int height, Color color)
+{
+    return (RenderItem){ .type = ITEM_PANEL, .dest = { (float)posX, (float)posY, (float)width, (float)height }, .tint = color };
+}
+
+static const char* ItemText(const RenderItem* item)
+{
+    return (item->text != NULL) ? item->text : textBuffer + item->textOffset;
+}
+
+static void DrawItem(const RenderItem* item)
+{
+    switch (item->type)
+    {
+    case ITEM_TEXTURE:
+    {
+        TrackDraw(item->texture.id, 1, item->dest);
+        DrawTexturePro(item->texture, item->source, item->dest, (Vector2){ 0 }, 0.0f, item->tint);
+    } break;
+    case ITEM_LABEL:
+    {
+        const char* text = ItemText(item);
+        TrackDraw(item->texture.id, GetCodepointCount(text), item->dest);
+        DrawGameText(text, (Vector2){ item->dest.x, item->dest.y }, item->fontSize, item->spacing, item->tint);
+    } break;
+    case ITEM_PANEL:
+    {
+        TrackDraw(SHAPES_TEXTURE_ID, 1, item->dest);
+        DrawRectangle((int)item->dest.x, (int)item->dest.y, (int)item->dest.width, (int)item->dest.height, item->tint);
+    } break;
+    default: break;
+    }
+}
+
+// SDF text switches shader on entering and leaving a run of labels, raylib flushes its batch both times
+static void BeginLabels(void)
+{
+    if (!IsGameTextShaded()) return;
+
+    BeginGameText();
+    stats.shaderSwitches += 1;
+    anyDrawn = false;
+}
+
+static void EndLabels(void)
+{
+    if (!IsGameTextShaded()) return;
+
+    EndGameText();
+    stats.shaderSwitches += 1;
+    anyDrawn = false;
+}
+
+static void DrawNow(RenderItem item)
+{
+    CountBatch(item.texture.id, &submitTexture, &anySubmitted, &stats.submittedDrawCalls);
+
+    if (item.type == ITEM_LABEL) BeginLabels();
+    DrawItem(&item);
+    if (item.type == ITEM_LABEL) EndLabels();
+}
+
+// Entering or leaving camera mode makes raylib flush its batch, like a texture change
+static void BeginCamera(Camera2D itemCamera)
+{
+    BeginMode2D(itemCamera);
+    drawCamera = itemCamera;
+    drawingCamera = true;
+    anyDrawn = false;
+}
+
+static void EndCamera(void)
+{
+    EndMode2D();
+    drawingCamera = false;
+    anyDrawn = false;
+}
+
+// Consecutive labels share one shader switch, the sort keeps a layer's labels together
+static void DrawItems(int from, int to)
+{
+    for (int i = from; i < to; ++i)
+    {
+        bool label = (queue[i].type == ITEM_LABEL);
+
+        if (label && ((i == from) || (queue[i - 1].type != ITEM_LABEL))) BeginLabels();
+        DrawItem(&queue[i]);
+        if (label && ((i + 1 == to) || (queue[i + 1].type != ITEM_LABEL))) EndLabels();
+    }
+}
+
+// Window area the view is upscaled to, a whole multiple of the resolution it is drawn at
+static Rectangle ViewArea(void)
+{
+    int width = viewWidth / pixelScale;
+    int height = viewHeight / pixelScale;
+    int scale = (int)fminf((float)(GetScreenWidth() / width), (float)(GetScreenHeight() / height));
+    if (scale < 1) scale = 1;
+
+    width *= scale;
+    height *= scale;
+    return (Rectangle){ (float)((GetScreenWidth() - width) / 2), (float)((GetScreenHeight() - height) / 2), (float)width, (float)height };
+}
+
+// Camera that takes a layer of the queue straight to the window, false when none is needed
+static bool WindowCamera(RenderLayer layer, Camera2D* windowCamera)
+{
+    bool world = hasCamera && (layer < FIRST_SCREEN_LAYER);
+
+    *windowCamera = world ? camera : (Camera2D){ .zoom = 1.0f };
+    if ((viewWidth == 0) || !hasCamera) return world;
+
+    Rectangle area = ViewArea();
+    float zoom = area.width / viewWidth;
+    windowCamera->offset.x = area.x + windowCamera->offset.x * zoom;
+    windowCamera->offset.y = area.y + windowCamera->offset.y * zoom;
+    windowCamera->zoom *= zoom;
+    return world || (area.x != 0.0f) || (area.y != 0.0f) || (zoom != 1.0f);
+}
+
+// Input reads view coordinates while a scene is drawn to the view, window coordinates otherwise
+static void MapMouse(bool toView)
+{
+    if (!toView)
+    {
+        SetMouseOffset(0, 0);
+        SetMouseScale(1.0f, 1.0f);
+        return;
+    }
+
+    Rectangle area = ViewArea();
+    float zoom = area.width / viewWidth;
+    SetMouseOffset(-(int)area.x, -(int)area.y);
+    SetMouseScale(1.0f / zoom, 1.0f / zoom);
+}
+
+// World layers at 1/pixelScale, upscaled in one quad
+static void DrawLowResWorld(int count, Rectangle area)
+{
+    Camera2D targetCamera = camera;
+    targetCamera.offset.x /= pixelScale;
+    targetCamera.offset.y /= pixelScale;
+    targetCamera.zoom /= pixelScale;
+
+    BeginTextureMode(lowRes);
+    framebuffer = (Vector2){ (float)lowRes.texture.width, (float)lowRes.texture.height };
+    ClearBackground(RAYWHITE);      // Same clear color the screen uses
+    BeginCamera(targetCamera);
+    DrawItems(0, count);
+    EndCamera();
+    RestoreTargetAlpha((Rectangle){ 0, 0, framebuffer.x, framebuffer.y });     // Blended onto the window next
+    EndTextureMode();
+    framebuffer = (Vector2){ (float)GetScreenWidth(), (float)GetScreenHeight() };
+
+    if ((area.width < GetScreenWidth()) || (area.height < GetScreenHeight())) ClearBackground(BLACK);
+
+    // NOTE: Render textures are stored upside down, hence the negative source height
+    Texture2D texture = lowRes.texture;
+    Rectangle source = { 0, 0, (float)texture.width, -(float)texture.height };
+    TrackDraw(texture.id, 1, area);
+    DrawTexturePro(texture, source, area, (Vector2){ 0 }, 0.0f, WHITE);
+}
+
+// World items straight to the window, clipped to the view when letterboxed
+static void DrawWindowItems(int from, int to, Rectangle area)
+{
+    if (from == to) return;
+
+    bool letterboxed = (area.width < GetScreenWidth()) || (area.height < GetScreenHeight());
+    if (letterboxed) BeginScissorMode((int)area.x, (int)area.y, (int)area.width, (int)area.height);
+
+    Camera2D windowCamera;
+    WindowCamera(RENDER_WORLD, &windowCamera);
+    BeginCamera(windowCamera);
+    DrawItems(from, to);
+    EndCamera();
+
+    if (letterboxed) EndScissorMode();
+}
+
+static void DrawWindowWorld(int count, Rectangle area)
+{
+    if ((area.width < GetScreenWidth()) || (area.height < GetScreenHeight()))
+    {
+        ClearBackground(BLACK);
+        TrackDraw(SHAPES_TEXTURE_ID, 1, area);
+        DrawRectangleRec(area, RAYWHITE);
+    }
+
+    DrawWindowItems(0, count, area);
+}
+
+// Double a buffer until it fits needed elements, false when out of memory
+static bool Reserve(void** buffer, int* capacity, int needed, int elementSize, int initial)
+{
+    if (needed <= *capacity) return true;
+
+    int grown = (*capacity > 0) ? *capacity : initial;
+    while (grown < needed) grown *= 2;
+
+    void* moved = MemRealloc(*buffer, grown * elementSize);
+    if (moved == NULL) return false;
+
+    *buffer = moved;
+    *capacity = grown;
+    return true;
+}
+
+static void Submit(RenderLayer layer, RenderItem item)
+{
+    // NOTE: Flushing early is no option, gameplay submits before BeginDrawing() to compare
+    // the frame with the last one
+    if (!Reserve((void**)&queue, &queueCapacity, queueCount + 1, sizeof(RenderItem), MAX_RENDER_ITEMS))
+    {
+        TraceLog(LOG_WARNING, "RENDER: Out of memory for %i items, dropped one", queueCount + 1);
+        return;
+    }
+
+    CountBatch(item.texture.id, &submitTexture, &anySubmitted, &stats.submittedDrawCalls);
+
+    item.layer = layer;
+    item.order = queueCount;
+    queue[queueCount] = item;
+    queueCount += 1;
+}
+
+static int CompareItems(const void* a, const void* b)
+{
+    const RenderItem* first = (const RenderItem*)a;
+    const RenderItem* second = (const RenderItem*)b;
+
+    if (first->layer != second->layer) return (first->layer < second->layer) ? -1 : 1;
+    return first->order - second->order;
+}
+
+// Area an item covers. The game flips art through the source, so its dest sizes are positive,
+// but a caller's dest with a negative size still covers the area on the other side of x, y.
+static Rectangle ItemBounds(const RenderItem* item)
+{
+    Rectangle bounds = item->dest;
+
+    if (bounds.width < 0) { bounds.x += bounds.width; bounds.width = -bounds.width; }
+    if (bounds.height < 0) { bounds.y += bounds.height; bounds.height = -bounds.height; }
+
+    return bounds;
+}
+
+// With the queue in layer and submit order, move each item back to right after the last one
+// of its layer sharing its texture, so it joins that batch. It stops at an item it overlaps,
+// their order decides what is on top. Items it passes do not overlap it, order is no matter.
+static void GroupByTexture(void)
+{
+    for (int i = 1; i < queueCount; ++i)
+    {
+        RenderItem item = queue[i];
+        Rectangle bounds = ItemBounds(&item);
+        int target = i;
+
+        for (int j = i - 1; (j >= 0) && (queue[j].layer == item.layer); --j)
+        {
+            if (queue[j].texture.id == item.texture.id)
+            {
+                target = j + 1;
+                break;
+            }
+
+            if (CheckCollisionRecs(ItemBounds(&queue[j]), bounds)) break;
+        }
+
+        if (target < i)
+        {
+            memmove(&queue[target + 1], &queue[target], (i - target) * sizeof(RenderItem));
+            queue[target] = item;
+        }
+    }
+}
+
+// FNV-1a, continued from hash
+static unsigned int HashBytes(unsigned int hash, const void* data, int size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (int i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+// Everything that decides the pixels an item covers, field by field to skip padding and pointers
+static unsigned int HashQueue(void)
+{
+    unsigned int hash = 2166136261u;
+
+    if (hasCamera)
+    {
+        hash = HashBytes(hash, &camera.offset, sizeof(camera.offset));
+        hash = HashBytes(hash, &camera.target, sizeof(camera.target));
+        hash = HashBytes(hash, &camera.rotation, sizeof(camera.rotation));
+        hash = HashBytes(hash, &camera.zoom, sizeof(camera.zoom));
+    }
+
+    for (int i = 0; i < queueCount; ++i)
+    {
+        const RenderItem* item = &queue[i];
+
+        hash = HashBytes(hash, &item->type, sizeof(item->type));
+        hash = HashBytes(hash, &item->layer, sizeof(item->layer));
+        hash = HashBytes(hash, &item->texture.id, sizeof(item->texture.id));
+        hash = HashBytes(hash, &item->source, sizeof(item->source));
+        hash = HashBytes(hash, &item->dest, sizeof(item->dest));
+        hash = HashBytes(hash, &item->tint, sizeof(item->tint));
+
+        if (item->type == ITEM_LABEL)
+        {
+            hash = HashBytes(hash, &item->fontSize, sizeof(item->fontSize));
+            hash = HashBytes(hash, &item->spacing, sizeof(item->spacing));
+            const char* text = ItemText(item);
+            hash = HashBytes(hash, text, (int)strlen(text));
+        }
+    }
+
+    return hash;
+}
+
+//----------------------------------------------------------------------------------
+// Render Functions Definition
+//----------------------------------------------------------------------------------
+void ResetDrawStats(void)
+{
+    stats = (DrawStats){ 0 };
+    framebuffer = (Vector2){ (float)GetScreenWidth(), (float)GetScreenHeight() };
+    boundTexture = SHAPES_TEXTURE_ID;
+    anyDrawn = false;
+    submitTexture = SHAPES_TEXTURE_ID;
+    anySubmitted = false;
+}
+
+DrawStats GetDrawStats(void)
+{
+    return stats;
+}
+
+void DrawSprite(Sprite sprite, Rectangle source, Rectangle dest, Color tint)
+{
+    RenderItem item;
+    if (SpriteItem(sprite, source, dest, tint, &item)) DrawNow(item);
+}
+
+void DrawLayer(TextureHandle layer, Vector2 position, float scale, Color tint)
+{
+    DrawNow(LayerItem(layer, position, scale, tint));
+}
+
+void DrawRenderTarget(RenderTexture2D target, Rectangle dest, Color tint)
+{
+    DrawNow(TargetItem(target, dest, tint));
+}
+
+void DrawLabel(const char* text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    DrawNow(LabelItem(text, position, fontSize, spacing, tint));
+}
+
+void DrawPanel(int posX, int posY, int width, int height, Color color)
+{
+    DrawNow(PanelItem(posX, posY, width, height, color));
+}
+
+// BLEND_ALPHA blends destination alpha like a color, a pixel drawn with alpha a over an opaque
+// one is left at a * a + (1 - a). Drawn with these factors, opaque black adds 1 - alpha to
+// alpha and nothing to the colors. raylib 4.0 has no separate alpha factors to avoid it.
+void RestoreTargetAlpha(Rectangle area)
+{
+    // Changing blend mode flushes the batch both ways
+    anyDrawn = false;
+    TrackDraw(SHAPES_TEXTURE_ID, 1, area);
+
+    rlSetBlendFactors(RENDER_BLEND_ONE_MINUS_DST_ALPHA, RENDER_BLEND_ONE, RENDER_BLEND_ADD);
+    BeginBlendMode(BLEND_CUSTOM);
+    DrawRectangleRec(area, BLACK);
+    EndBlendMode();
+
+    anyDrawn = false;
+}
+
+void SubmitSprite(RenderLayer layer, Sprite sprite, Rectangle source, Rectangle dest, Color tint)
+{
+    RenderItem item;
+    if (SpriteItem(sprite, source, dest, tint, &item)) Submit(layer, item);
+}
+
+void SubmitLayer(RenderLayer layer, TextureHandle texture, Vector2 position, float scale, Color tint)
+{
+    Submit(layer, LayerItem(texture, position, scale, tint));
+}
+
+void SubmitRenderTarget(RenderLayer layer, RenderTexture2D target, Rectangle dest, Color tint)
+{
+    Submit(layer, TargetItem(target, dest, tint));
+}
+
+void SubmitLabel(RenderLayer layer, const char* text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    RenderItem item = LabelItem(text, position, fontSize, spacing, tint);
+
+    // Not cached yet, the glyphs are laid out at flush time from a copy of the text
+    if (item.type == ITEM_LABEL)
+    {
+        int length = (int)strlen(text) + 1;
+
+        if (!Reserve((void**)&textBuffer, &textCapacity, textUsed + length, 1, RENDER_TEXT_BUFFER))
+        {
+            TraceLog(LOG_WARNING, "RENDER: Out of memory for label text, dropped \"%s\"", text);
+            return;
+        }
+
+        memcpy(textBuffer + textUsed, text, length);
+        item.text = NULL;
+        item.textOffset = textUsed;
+        textUsed += length;
+    }
+
+    Submit(layer, item);
+}
+
+void SubmitPanel(RenderLayer layer, int posX, int posY, int width, int height, Color color)
+{
+    Submit(layer, PanelItem(posX, posY, width, height, color));
+}
+
+void SetRenderView(int width, int height, int scale)
+{
+    UnloadRenderView();
+
+    viewWidth = width;
+    viewHeight = height;
+    pixelScale = (scale > 1) ? scale : 1;
+
+    if (pixelScale > 1)
+    {
+        lowRes = LoadRenderTexture(width / pixelScale, height / pixelScale);
+        SetTextureFilter(lowRes.texture, TEXTURE_FILTER_POINT);
+    }
+}
+
+void UnloadRenderView(void)
+{
+    if (lowRes.id != 0) UnloadRenderTexture(lowRes);
+
+    lowRes = (RenderTexture2D){ 0 };
+    viewWidth = 0;
+    viewHeight = 0;
+    pixelScale = 1;
+}
+
+Vector2 GetRenderViewSize(void)
+{
+    if (viewWidth == 0) return (Vector2){ (float)GetScreenWidth(), (float)GetScreenHeight() };
+    return (Vector2){ (float)viewWidth, (float)viewHeight };
+}
+
+int GetRenderPixelScale(void)
+{
+    return pixelScale;
+}
+
+void SetRenderCamera(Camera2D renderCamera)
+{
+    camera = renderCamera;
+    hasCamera = true;
+}
+
+// NOTE: Camera rotation is not accounted for, the scenes never rotate
+Rectangle GetRenderView(void)
+{
+    Vector2 size = GetRenderViewSize();
+    if (!hasCamera) return (Rectangle){ 0, 0, size.x, size.y };
+
+    Vector2 topLeft = GetScreenToWorld2D((Vector2){ 0, 0 }, camera);
+    Vector2 bottomRight = GetScreenToWorld2D(size, camera);
+    return (Rectangle){ topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y };
+}
+
+bool IsInRenderView(Rectangle bounds)
+{
+    if (CheckCollisionRecs(GetRenderView(), bounds)) return true;
+
+    stats.culled += 1;
+    return false;
+}
+
+void CountCulled(int count)
+{
+    stats.culled += count;
+}
+
+void FlushRenderQueue(void)
+{
+    flushedHash = HashQueue();
+
+    if (queueCount > 0) qsort(queue, queueCount, sizeof(RenderItem), CompareItems);
+    GroupByTexture();
+
+    // World layers sort first, world text last of them
+    int worldCount = 0;
+    while (worldCount < queueCount && queue[worldCount].layer < FIRST_SCREEN_LAYER) worldCount += 1;
+    int artCount = 0;
+    while (artCount < worldCount && queue[artCount].layer < RENDER_WORLD_TEXT) artCount += 1;
+
+    bool toView = (viewWidth != 0) && hasCamera;
+    MapMouse(toView);
+
+    if (toView)
+    {
+        Rectangle area = ViewArea();
+
+        if (pixelScale > 1)
+        {
+            DrawLowResWorld(artCount, area);
+            DrawWindowItems(artCount, worldCount, area);
+        }
+        else DrawWindowWorld(worldCount, area);
+    }
+    else if (hasCamera)
+    {
+        BeginCamera(camera);
+        DrawItems(0, worldCount);
+        EndCamera();
+    }
+    else DrawItems(0, worldCount);
+
+    Camera2D windowCamera;
+    bool useCamera = WindowCamera(FIRST_SCREEN_LAYER, &windowCamera);
+
+    if (useCamera) BeginCamera(windowCamera);
+    DrawItems(worldCount, queueCount);
+    if (useCamera) EndCamera();
+
+    queueCount = 0;
+    textUsed = 0;
+    hasCamera = false;
+}
+
+bool HasRenderQueueChanged(void)
+{
+    return HashQueue() != flushedHash;
+}
+
+void DiscardRenderQueue(void)
+{
+    queueCount = 0;
+    textUsed = 0;
+    hasCamera = false;
+}
+
+void UnloadRenderQueue(void)
+{
+    MemFree(queue);
+    MemFree(textBuffer);
+
+    queue = NULL;
+    queueCapacity = 0;
+    textBuffer = NULL;
+    textCapacity = 0;
+    DiscardRenderQueue();
+}
@@ -0,0 +1,87 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "raylib.h"
+#include "texture_cache.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define MAX_RENDER_ITEMS 512			// Queue size to start with, doubled when a frame submits more
+#define RENDER_TEXT_BUFFER 4096			// Label text is copied, callers may reuse their buffers. Grows too.
+
+// Submitted items draw layer by layer, inside a layer they are grouped by texture as far as
+// that keeps overlapping items in submit order. Items in a higher layer are always on top,
+// whatever they overlap. World layers are
+// in scene coordinates and drawn through the render camera, UI layers are in view coordinates,
+// the window unless SetRenderView() fixed a size.
+typedef enum RenderLayer
+{
+	RENDER_BACKGROUND = 0,	// Full screen layers
+	RENDER_WORLD,			// Props and clickables
+	RENDER_ACTORS,			// Player and anything walking in front of props
+	RENDER_WORLD_TEXT,		// Hover descriptions, at window resolution whatever the pixel scale
+	RENDER_UI_PANELS,		// First layer drawn in screen coordinates
+	RENDER_UI,				// Inventory icons
+	RENDER_UI_TEXT,
+	RENDER_LAYER_COUNT
+} RenderLayer;
+
+typedef struct DrawStats
+{
+	int drawCalls;			// Batches raylib has to flush, one per texture change
+	int submittedDrawCalls;	// What the submitted items would have cost drawn in submit order
+	int textureSwitches;
+	int shaderSwitches;		// Entering and leaving runs of SDF text, each flushes like a texture switch
+	int quads;
+	int vertices;
+	int pixels;				// Pixels covered in whatever is drawn to, overdraw included, i.e. fill cost
+	int culled;				// Items skipped by IsInRenderView(), never submitted
+	int trimmedPixels;		// Transparent margins of trimmed sprites left out of their quads
+} DrawStats;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Render Functions Declaration
+	//----------------------------------------------------------------------------------
+	void ResetDrawStats(void);			// Call once per frame, before drawing
+	DrawStats GetDrawStats(void);
+
+	// Immediate, drawn in call order
+	void DrawSprite(Sprite sprite, Rectangle source, Rectangle dest, Color tint);	// Source is relative to the sprite region
+	void DrawLayer(TextureHandle layer, Vector2 position, float scale, Color tint);		// Scale in source art pixels, variants are accounted for
+	void DrawRenderTarget(RenderTexture2D target, Rectangle dest, Color tint);
+	void DrawLabel(const char* text, Vector2 position, float fontSize, float spacing, Color tint);	// Game font, see text.h
+	void DrawPanel(int posX, int posY, int width, int height, Color color);
+	void RestoreTargetAlpha(Rectangle area);	// Inside BeginTextureMode(), fills alpha back to opaque, colors are kept
+
+	// Queued, drawn by layer and grouped by texture on FlushRenderQueue()
+	void SubmitSprite(RenderLayer layer, Sprite sprite, Rectangle source, Rectangle dest, Color tint);
+	void SubmitLayer(RenderLayer layer, TextureHandle texture, Vector2 position, float scale, Color tint);
+	void SubmitRenderTarget(RenderLayer layer, RenderTexture2D target, Rectangle dest, Color tint);
+	void SubmitLabel(RenderLayer layer, const char* text, Vector2 position, float fontSize, float spacing, Color tint);
+	void SubmitPanel(RenderLayer layer, int posX, int posY, int width, int height, Color color);
+	// Lay the scene out in a fixed view and draw its world layers but text at 1/pixelScale of it, then
+	// upscale by whole steps to the window, letterboxed. Pixel scale 1 draws them at window size.
+	void SetRenderView(int width, int height, int pixelScale);
+	void UnloadRenderView(void);
+	Vector2 GetRenderViewSize(void);		// What the camera and UI are laid out for, the window without a view
+	int GetRenderPixelScale(void);
+
+	void SetRenderCamera(Camera2D camera);	// Camera for the world layers of what is submitted until the next flush
+	Rectangle GetRenderView(void);			// Scene area the render camera shows, the whole view without one
+	bool IsInRenderView(Rectangle bounds);	// Test scene bounds before submitting, counts what is culled
+	void CountCulled(int count);			// Bounds tested against GetRenderView() by the caller instead
+	void FlushRenderQueue(void);		// Draw and clear everything submitted, call inside BeginDrawing()
+	bool HasRenderQueueChanged(void);	// Compare what is queued with what the last flush drew
+	void DiscardRenderQueue(void);		// Clear everything submitted without drawing it
+	void UnloadRenderQueue(void);		// Free what the queue grew to, used at exit
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RENDER_H
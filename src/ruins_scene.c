@@ -1,92 +1,149 @@
 #include "raylib.h"
 #include "scenes.h"
+#include "texture_cache.h"
+#include "render.h"
+#include "text.h"
+#include "background.h"
+#include "input.h"
+#include "text_cache.h"
+#include "hotspots.h"
+#include "navigation.h"
 
 #define BACKGROUND_LAYERS 7
+#define FLOOR_TOP 492             // Feet of the player standing at y 300, the old lowest it could go
 #define CLICKABLE_OBJECTS 1
 
-static Texture2D background_layers[BACKGROUND_LAYERS];
+static const BackgroundLayer ruinsLayers[BACKGROUND_LAYERS] = {
+    { "data/1.png", { 0, -40 }, 2.0f, LAYER_STATIC },
+    { "data/2.png", { 0, -40 }, 2.0f, LAYER_STATIC },
+    { "data/3.png", { 0, -40 }, 2.0f, LAYER_STATIC },
+    { "data/4.png", { 0, -40 }, 2.0f, LAYER_STATIC },
+    { "data/5.png", { 0, -40 }, 2.0f, LAYER_STATIC },
+    { "data/6.png", { 0, -40 }, 2.0f, LAYER_STATIC },
+    { "data/7.png", { 0, -40 }, 2.0f, LAYER_STATIC },
+};
 
-static ClickableObject clickableObjects[CLICKABLE_OBJECTS];
+// Images InitRuinsScene loads besides the background layers
+static const char* ruinsSceneSprites[] = {
+    "data/GraveRobber.png", "data/GraveRobber_walk2.png"
+};
+
+static Background background = { 0 };
+static NavMesh navMesh = { 0 };
+static Camera2D camera = { 0 };         // As last drawn, the mouse is picked through it
+
+static SceneObjects objects = { 0 };
 
-static int framesCounter = 0;
 static int showInventory = 0;
 static int showDialogue = 0;
 static int selectedObject = -1;
 static int highlight = -1;
+static HotspotGrid hotspots = { 0 };
+static bool hotspotsMoved = true;     // Clickables moved, appeared or were taken since the grid was built
 
 void InitRuinsScene(Font font)
 {
     // Init global variables
-    framesCounter = 0;
-
     player_idle_animation = (Animation){ 0 };
     player_walk_animation = (Animation){ 0 };
 
     // locals
-    framesCounter = 0;
     showInventory = 0;
     showDialogue = 0;
     selectedObject = -1;
     highlight = -1;
+    hotspotsMoved = true;
 
     // BACKGROUNDS ////////////////////////////////////////////////////////////
-    background_layers[0] = LoadTexture("data/1.png");
-    background_layers[1] = LoadTexture("data/2.png");
-    background_layers[2] = LoadTexture("data/3.png");
-    background_layers[3] = LoadTexture("data/4.png");
-    background_layers[4] = LoadTexture("data/5.png");
-    background_layers[5] = LoadTexture("data/6.png");
-    background_layers[6] = LoadTexture("data/7.png");
+    LoadBackground(&background, ruinsLayers, BACKGROUND_LAYERS);
+
+    // Whole width of the scene below the floor line, no blockers yet
+    Vector2 corner = { MAX(background.size.x, GetRenderViewSize().x), MAX(background.size.y, GetRenderViewSize().y) };
+    Vector2 floor[] = { { 0, FLOOR_TOP }, { corner.x, FLOOR_TOP }, { corner.x, corner.y }, { 0, corner.y } };
+    LoadNavMesh(&navMesh, floor, 4, 0, 0, NAV_CELL_SIZE);
 
     // PLAYER /////////////////////////////////////////////////////////////////
-    player_idle_animation.sprite = LoadTexture("data/GraveRobber.png");
+    player_idle_animation.sprite = AcquireSprite("data/GraveRobber.png");
     player_idle_animation.total_frames = 1;
 
-    player_walk_animation.sprite = LoadTexture("data/GraveRobber_walk2.png");
+    player_walk_animation.sprite = AcquireSprite("data/GraveRobber_walk2.png");
     player_walk_animation.total_frames = 6;
 
     player.position = (Vector2){ 0, 300 };
+    player.previous_position = player.position;
     player.size = (Vector2){ 48, 48 };
     player.scale = (Vector2){ 4, 4 };
     player.animation = player_idle_animation;
-    player_target = (Vector2){ 0, 300 };
-    
+    UpdateWorldObjectBounds(&player);
+    StopPlayer();
+
+    // No clickables in the ruins yet
+    LoadSceneObjects(&objects, CLICKABLE_OBJECTS);
+
+    camera = FollowCamera(player.bounds, background.size);
+}
+
+const char** GetRuinsSceneImages(int* count)
+{
+    static const char* images[BACKGROUND_LAYERS + sizeof(ruinsSceneSprites) / sizeof(ruinsSceneSprites[0])];
+
+    for (int i = 0; i < BACKGROUND_LAYERS; ++i) images[i] = ruinsLayers[i].fileName;
+    for (int i = BACKGROUND_LAYERS; i < (int)(sizeof(images) / sizeof(images[0])); ++i) images[i] = ruinsSceneSprites[i - BACKGROUND_LAYERS];
+
+    *count = sizeof(images) / sizeof(images[0]);
+    return images;
+}
+
+static void UpdateRuinsHotspots(void)
+{
+    if (!hotspotsMoved) return;
+
+    // Taken items keep an empty rectangle so indices still match objects
+    Rectangle bounds[CLICKABLE_OBJECTS];
+    GetSceneObjectHotspots(&objects, bounds);
+
+    BuildHotspotGrid(&hotspots, bounds, objects.count, HOTSPOT_CELL_SIZE);
+    hotspotsMoved = false;
+}
+
+// Animations step with the fixed update, drawing may happen at any rate
+static void AnimateRuinsScene(void)
+{
+    AdvanceAnimation(&player.animation);
+    AnimateSceneObjects(&objects);
 }
 
 void UpdateRuinsScene()
 {
+    player.previous_position = player.position;
+    AnimateRuinsScene();
+
     dir = 1;
-    hover = 0;
-    highlight = -1;
-    mousePosition = GetMousePosition();
+    mousePosition = GetInputMousePosition();
+    Vector2 worldMouse = GetScreenToWorld2D(mousePosition, camera);
 
     showDialogue = UpdateDialogue(showDialogue);
     if (showDialogue == 1)
+    {
+        highlight = -1;
         return;
+    }
 
     showInventory = (mousePosition.y < INVENTORY_OPEN) ? 1 : 0;
 
-    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+    if (IsInputMousePressed(MOUSE_LEFT_BUTTON))
     {
-        selectedObject = 0;
+        selectedObject = -1;
 
-        player_target.x = mousePosition.x - (player.size.x * player.scale.x) / 2;
-        player_target.y = mousePosition.y - player.size.y * player.scale.y;
-        player_target.y = MAX(player_target.y, 300);
+        WalkPlayerTo(&navMesh, worldMouse);
         player.animation = player_walk_animation;
     }
 
-    for (int i = 0; i < CLICKABLE_OBJECTS; ++i)
+    UpdateRuinsHotspots();
+    highlight = PickSceneObject(&objects, &hotspots, worldMouse);
+    if ((highlight != -1) && IsInputMousePressed(MOUSE_LEFT_BUTTON))
     {
-        if (CheckCollisionPointRec(mousePosition, WorldObjectToRect(&clickableObjects[i].world_item)))
-        {
-            if (!clickableObjects[i].isTaken)
-                highlight = i;
-            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
-            {
-                selectedObject = i;
-            }
-        }
+        selectedObject = highlight;
     }
 
     if ((int)player.position.x == (int)player_target.x && (int)player.position.y == (int)player_target.y)
@@ -94,19 +151,26 @@ void UpdateRuinsScene()
         player.animation = player_idle_animation;
         if (selectedObject != -1)
         {
-            if (clickableObjects[selectedObject].canOpen)
+            unsigned char flags = objects.flags[selectedObject];
+
+            if (flags & OBJECT_CAN_OPEN)
             {
-                clickableObjects[selectedObject].isOpen = true;
+                objects.flags[selectedObject] |= OBJECT_OPEN;
             }
-            else if (clickableObjects[selectedObject].canTake)
+            else if (flags & OBJECT_CAN_TAKE)
             {
-                PickUpItem(&clickableObjects[selectedObject]);
+                PickUpItem(&objects, selectedObject);
+                hotspotsMoved = true;
                 selectedObject = -1;
             }
-            else if (clickableObjects[selectedObject].canTalk)
+            else if (flags & OBJECT_CAN_TALK)
             {
-                showDialogue = 1;
-                visible_dialogue = clickableObjects[selectedObject].npc->dialogue[clickableObjects[selectedObject].npc->current_dialogue];
+                NPC* npc = objects.npcs[selectedObject];
+                if (StartDialogue(&npc->dialogue, 0))
+                {
+                    showDialogue = 1;
+                    visible_dialogue = &npc->dialogue;
+                }
                 selectedObject = -1;
             }
         }
@@ -123,67 +187,46 @@ void UpdateRuinsScene()
 
 void DrawRuinsScene(Font font)
 {
-    for (int i = 0; i < BACKGROUND_LAYERS; ++i)
-    {
-        DrawTextureEx(background_layers[i], (Vector2) { 0, -40 }, 0, 2, WHITE);
-    }
-    if (++framesCounter >= (60 / player.animation.total_frames))
-    {
-        player.animation.frame = (player.animation.frame + 1) % player.animation.total_frames;
-        framesCounter = 0;
-    }
+    camera = FollowCamera(WorldObjectToDrawRect(&player), background.size);
+    SetRenderCamera(camera);
 
-    for (int i = 0; i < CLICKABLE_OBJECTS; ++i)
-    {
-        if (clickableObjects[i].isTaken)
-            continue;
-        if (clickableObjects[i].isOpen)
-        {
-            clickableObjects[i].world_item.animation.frame = MIN(clickableObjects[i].world_item.animation.frame + 1, clickableObjects[i].world_item.animation.total_frames - 1);
-        }
-        DrawTexturePro(
-            clickableObjects[i].world_item.animation.sprite,
-            (Rectangle) {
-            clickableObjects[i].world_item.size.x* clickableObjects[i].world_item.animation.frame, 0, clickableObjects[i].world_item.size.x, clickableObjects[i].world_item.size.y
-        },
-            WorldObjectToRect(&clickableObjects[i].world_item),
-                zero,
-                0.0f,
-                WHITE
-                );
+    DrawBackground(&background);
 
-    }
+    SubmitSceneObjects(&objects, RENDER_WORLD);
 
+    // The camera follows the player, never out of view
     Rectangle source = { player.size.x * player.animation.frame, 0, dir * player.size.x, player.size.y };
-    DrawTexturePro(player.animation.sprite, source, WorldObjectToRect(&player), zero, 0.0f, WHITE);
+    SubmitSprite(RENDER_ACTORS, player.animation.sprite, source, WorldObjectToDrawRect(&player), WHITE);
 
     if (highlight != -1)
     {
-        Vector2 location = { clickableObjects[highlight].world_item.position.x - 40, clickableObjects[highlight].world_item.position.y };
-        DrawTextEx(font, clickableObjects[highlight].description, location, font.baseSize * 2, 4, WHITE);
+        Vector2 location = { objects.positions[highlight].x - 40, objects.positions[highlight].y };
+        SubmitLabel(RENDER_WORLD_TEXT, objects.descriptions[highlight], location, font.baseSize * 2, 4, WHITE);
     }
 
     if (showInventory != 0)
     {
-        DrawRectangle(0, 0, GetScreenWidth(), INVENTORY_OPEN, DARKGRAY);
+        SubmitPanel(RENDER_UI_PANELS, 0, 0, (int)GetRenderViewSize().x, INVENTORY_OPEN, DARKGRAY);
         for (int i = 0; i < player_inventory.items_taken; ++i)
         {
             float scale = 4.0f;
-            Texture2D* sprite = &player_inventory.items[i].object_sprite;
-            Rectangle source = { 0, 0, sprite->width, sprite->height };
-            Rectangle dest = { 20 * i, 20, sprite->width * scale, sprite->height * scale };
-            DrawTexturePro(*sprite, source, dest, zero, 0.0f, WHITE);
+            Sprite* sprite = &player_inventory.items[i].object_sprite;
+            Vector2 size = { sprite->region.width / sprite->scale, sprite->region.height / sprite->scale };
+            Rectangle source = { 0, 0, size.x, size.y };
+            Rectangle dest = { 20 * i, 20, size.x * scale, size.y * scale };
+            SubmitSprite(RENDER_UI, *sprite, source, dest, WHITE);
         }
     }
 
     if (showDialogue != 0)
     {
-        DrawRectangle(0, 300, GetScreenWidth(), DIALOGUE_OPEN, DARKGRAY);
-        DrawTextEx(font, visible_dialogue->spoken_dialogue, (Vector2) { 20, 300 }, font.baseSize * 2, 4, YELLOW);
+        SubmitPanel(RENDER_UI_PANELS, 0, 300, (int)GetRenderViewSize().x, DIALOGUE_OPEN, DARKGRAY);
+        SetTextCacheGroup(TEXT_GROUP_DIALOGUE);     // Evicted when the dialogue closes
+        SubmitLabel(RENDER_UI_TEXT, visible_dialogue->spoken_dialogue, (Vector2) { 20, 300 }, font.baseSize * 2, 4, YELLOW);
         for (int i = 0; i < visible_dialogue->total_answers; ++i)
         {
-            DrawTextEx(
-                font,
+            SubmitLabel(
+                RENDER_UI_TEXT,
                 visible_dialogue->answer_dialogue_options[i],
                 (Vector2) {
                 visible_dialogue->dialogue_location[i].x, visible_dialogue->dialogue_location[i].y
@@ -193,25 +236,18 @@ void DrawRuinsScene(Font font)
                     hover == i ? GREEN : BLUE);
         }
 
-        DrawTextEx(font, "Exit", (Vector2) { 600, 400 }, font.baseSize, 4, RED);
+        SubmitLabel(RENDER_UI_TEXT, "Exit", (Vector2) { 600, 400 }, font.baseSize, 4, RED);
+        SetTextCacheGroup(TEXT_GROUP_UI);
     }
 }
 
 void UnloadRuinsScene()
 {
-    for (int i = 0; i < BACKGROUND_LAYERS; ++i)
-    {
-        UnloadTexture(background_layers[i]);
-    }
-    for (int i = 0; i < CLICKABLE_OBJECTS; ++i)
-    {
-        UnloadTexture(clickableObjects[i].world_item.animation.sprite);
-    }
-    for (int i = 0; i < player_inventory.items_taken; ++i)
-    {
-        UnloadTexture(player_inventory.items[i].object_sprite);
-    }
+    UnloadBackground(&background);
+    UnloadHotspotGrid(&hotspots);
+    UnloadNavMesh(&navMesh);
+    UnloadSceneObjects(&objects);
 
-    UnloadTexture(player_idle_animation.sprite);
-    UnloadTexture(player_walk_animation.sprite);
+    ReleaseSprite(player_idle_animation.sprite);
+    ReleaseSprite(player_walk_animation.sprite);
 }
\ No newline at end of file
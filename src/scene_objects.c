@@ -0,0 +1,172 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Scene objects: clickables used to be one struct each, copied by value into an array,
+*   so picking and drawing pulled descriptions, inventory sprites and NPCs through the cache
+*   to read a rectangle. Each component now has its own array, see SceneObjects in scenes.h,
+*   and the loops below only touch the arrays they need.
+*
+*   Picking runs every update for the highlight, but an idle mouse over an idle scene picks
+*   the same object again and again. The objects keep a version that changes with anything a
+*   pick reads, and PickSceneObject() reuses its last answer while point and version hold.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "scenes.h"
+#include "texture_cache.h"
+#include "render.h"
+#include "hotspots.h"
+
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Scene Objects Functions Definition
+//----------------------------------------------------------------------------------
+void LoadSceneObjects(SceneObjects* objects, int capacity)
+{
+    *objects = (SceneObjects){ 0 };
+    objects->capacity = capacity;
+    objects->version = 1;           // Nothing picked yet
+
+    objects->bounds = (Rectangle*)MemAlloc(capacity * sizeof(Rectangle));
+    objects->flags = (unsigned char*)MemAlloc(capacity);
+    objects->sizes = (Vector2*)MemAlloc(capacity * sizeof(Vector2));
+    objects->animations = (Animation*)MemAlloc(capacity * sizeof(Animation));
+
+    objects->positions = (Vector2*)MemAlloc(capacity * sizeof(Vector2));
+    objects->scales = (Vector2*)MemAlloc(capacity * sizeof(Vector2));
+    objects->inventorySprites = (Sprite*)MemAlloc(capacity * sizeof(Sprite));
+    objects->descriptions = (char(*)[MAX_DESCRIPTION])MemAlloc(capacity * MAX_DESCRIPTION);
+    objects->npcs = (NPC**)MemAlloc(capacity * sizeof(NPC*));
+}
+
+void UnloadSceneObjects(SceneObjects* objects)
+{
+    for (int i = 0; i < objects->count; ++i)
+    {
+        ReleaseSprite(objects->animations[i].sprite);
+        ReleaseSprite(objects->inventorySprites[i]);
+    }
+
+    MemFree(objects->bounds);
+    MemFree(objects->flags);
+    MemFree(objects->sizes);
+    MemFree(objects->animations);
+    MemFree(objects->positions);
+    MemFree(objects->scales);
+    MemFree(objects->inventorySprites);
+    MemFree(objects->descriptions);
+    MemFree(objects->npcs);
+    *objects = (SceneObjects){ 0 };
+}
+
+int AddSceneObject(SceneObjects* objects, Animation animation, Vector2 position, Vector2 size, Vector2 scale, unsigned char flags, const char* description)
+{
+    if (objects->count == objects->capacity)
+    {
+        TraceLog(LOG_WARNING, "SCENE: [%s] Not added, %i objects already", description, objects->capacity);
+        ReleaseSprite(animation.sprite);
+        return -1;
+    }
+
+    int i = objects->count;
+    objects->count += 1;
+
+    objects->flags[i] = flags;
+    objects->sizes[i] = size;
+    objects->animations[i] = animation;
+    objects->positions[i] = position;
+    objects->scales[i] = scale;
+    objects->inventorySprites[i] = (Sprite){ 0 };
+    objects->npcs[i] = NULL;
+
+    strncpy(objects->descriptions[i], description, MAX_DESCRIPTION - 1);
+    objects->descriptions[i][MAX_DESCRIPTION - 1] = '\0';
+
+    // Picks test its pixels, the mask is baked while the scene loads
+    BakeSpriteHitMask(animation.sprite);
+
+    UpdateSceneObjectBounds(objects, i);
+    return i;
+}
+
+// Call whenever position, size or scale change
+void UpdateSceneObjectBounds(SceneObjects* objects, int index)
+{
+    Vector2 position = objects->positions[index];
+    Vector2 size = objects->sizes[index];
+    Vector2 scale = objects->scales[index];
+
+    objects->bounds[index] = (Rectangle){ position.x, position.y, size.x * scale.x, size.y * scale.y };
+    objects->version += 1;
+}
+
+// Opened objects play their sheet once, with the fixed update
+void AnimateSceneObjects(SceneObjects* objects)
+{
+    for (int i = 0; i < objects->count; ++i)
+    {
+        if ((objects->flags[i] & (OBJECT_OPEN | OBJECT_TAKEN)) != OBJECT_OPEN) continue;
+
+        // NOTE: Picks test the pixels of the frame shown
+        int frame = objects->animations[i].frame;
+        PlayAnimationOnce(&objects->animations[i], OPEN_ANIMATION_FPS);
+        if (objects->animations[i].frame != frame) objects->version += 1;
+    }
+}
+
+void GetSceneObjectHotspots(const SceneObjects* objects, Rectangle* bounds)
+{
+    for (int i = 0; i < objects->count; ++i) bounds[i] = (objects->flags[i] & OBJECT_TAKEN) ? (Rectangle){ 0 } : objects->bounds[i];
+}
+
+// Exact pick after the bounds test, over a solid pixel of the frame as drawn at bounds
+bool IsPointOnSceneObject(const SceneObjects* objects, int index, Vector2 point)
+{
+    Vector2 size = objects->sizes[index];
+    Rectangle source = { size.x * objects->animations[index].frame, 0, size.x, size.y };
+
+    return CheckCollisionPointSprite(objects->animations[index].sprite, source, objects->bounds[index], point);
+}
+
+// Grid built from GetSceneObjectHotspots() after the last change to bounds or taken flags
+int PickSceneObject(SceneObjects* objects, const HotspotGrid* grid, Vector2 point)
+{
+    if ((objects->pickedVersion == objects->version) && (objects->pickedPoint.x == point.x) && (objects->pickedPoint.y == point.y)) return objects->picked;
+
+    int hit = FindHotspot(grid, point);
+    while ((hit != -1) && !IsPointOnSceneObject(objects, hit, point)) hit = FindHotspotBelow(grid, point, hit);
+
+    objects->pickedVersion = objects->version;
+    objects->pickedPoint = point;
+    objects->picked = hit;
+    return hit;
+}
+
+void SubmitSceneObjects(const SceneObjects* objects, RenderLayer layer)
+{
+    // NOTE: The view is worked out once, IsInRenderView() would do it per object
+    Rectangle view = GetRenderView();
+    int culled = 0;
+
+    for (int i = 0; i < objects->count; ++i)
+    {
+        if (objects->flags[i] & OBJECT_TAKEN) continue;
+
+        if (!CheckCollisionRecs(view, objects->bounds[i]))
+        {
+            culled += 1;
+            continue;
+        }
+
+        Vector2 size = objects->sizes[i];
+        Rectangle source = { size.x * objects->animations[i].frame, 0, size.x, size.y };
+        SubmitSprite(layer, objects->animations[i].sprite, source, objects->bounds[i], WHITE);
+    }
+
+    CountCulled(culled);
+}
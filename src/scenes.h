@@ -2,6 +2,11 @@
 #define SCENES_H
 
 #include "raylib.h"
+#include "texture_cache.h"
+#include "render.h"
+#include "navigation.h"
+#include "hotspots.h"
+#include "dialogue.h"
 
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
@@ -9,9 +14,8 @@
 #define MAX_INVENTORY 10
 #define INVENTORY_OPEN 80
 #define DIALOGUE_OPEN 120
-#define MAX_DIALOGUES 1
-#define MAX_OPTIONS 3
 #define MAX_DESCRIPTION 128
+#define OPEN_ANIMATION_FPS 60.0f
 
 #define MIN(a,b) (((a)<(b))?(a):(b))
 #define MAX(a,b) (((a)>(b))?(a):(b))
@@ -20,52 +24,67 @@ typedef enum GameScene { FOREST = 0, RUINS } GameScene;
 
 typedef struct Animation
 {
-	Texture2D sprite;
+	Sprite sprite;
 	int total_frames;
 	int frame;
+	float timer;			// Seconds into the current frame
 } Animation;
 
 typedef struct InventoryObject
 {
-	Texture2D object_sprite;
+	Sprite object_sprite;
 } InventoryObject;
 
 typedef struct WorldObject
 {
 	Vector2 position;
+	Vector2 previous_position;	// Before the last update, drawing interpolates from here
 	Vector2 size;
 	Vector2 scale;
+	Rectangle bounds;			// WorldObjectToRect() as of the last update, for picking and culling
 	Animation animation;
 } WorldObject;
 
-typedef struct Dialogue
-{
-	char* spoken_dialogue;
-	int total_answers;
-	char* answer_dialogue_options[MAX_OPTIONS];
-	Rectangle dialogue_location[MAX_OPTIONS];
-	bool answer_selected;
-	int chosen_answer;
-} Dialogue;
-
 typedef struct NPC
 {
-	int current_dialogue;
-	Dialogue* dialogue[MAX_DIALOGUES];
+	Dialogue dialogue;			// Talks start from the first node of its graph
 } NPC;
 
-typedef struct ClickableObject
+typedef enum SceneObjectFlag
+{
+	OBJECT_CAN_OPEN = 1 << 0,
+	OBJECT_OPEN = 1 << 1,
+	OBJECT_CAN_TAKE = 1 << 2,
+	OBJECT_TAKEN = 1 << 3,
+	OBJECT_CAN_TALK = 1 << 4
+} SceneObjectFlag;
+
+// Clickable objects of a scene, one array per component, an object is an index into all of
+// them. Picking, animating and drawing only walk the arrays they read.
+typedef struct SceneObjects
 {
-	WorldObject world_item;
-	InventoryObject inventory_item;
-	char description[MAX_DESCRIPTION];
-	bool canOpen;
-	bool isOpen;
-	bool canTake;
-	bool isTaken;
-	bool canTalk;
-	NPC* npc;
-} ClickableObject;
+	int count;
+	int capacity;
+
+	// Hot, every update and draw reads these
+	Rectangle* bounds;			// Position, size and scale combined, for picking and culling
+	unsigned char* flags;		// SceneObjectFlag
+	Vector2* sizes;				// One frame of the sheet, source art pixels
+	Animation* animations;
+
+	// Cold, only for the object the player deals with
+	Vector2* positions;
+	Vector2* scales;
+	Sprite* inventorySprites;	// Zero for objects that cannot be taken
+	char (*descriptions)[MAX_DESCRIPTION];
+	NPC** npcs;
+
+	// Last pick, see PickSceneObject()
+	unsigned int version;		// Changes whenever bounds, a taken flag or a shown frame do
+	unsigned int pickedVersion;
+	Vector2 pickedPoint;
+	int picked;
+} SceneObjects;
 
 typedef struct Inventory
 {
@@ -97,14 +116,35 @@ extern "C" {            // Prevents name mangling of functions
 
 	void ChangeScene(GameScene);
 	Rectangle WorldObjectToRect(WorldObject*);
-	void PickUpItem(ClickableObject*);
+	Rectangle WorldObjectToDrawRect(WorldObject*);
+	void UpdateWorldObjectBounds(WorldObject*);
+	Camera2D FollowCamera(Rectangle, Vector2);
+	void AdvanceAnimation(Animation*);
+	void PlayAnimationOnce(Animation*, float);
+	void PickUpItem(SceneObjects*, int);
 	int UpdateDialogue(int);
+	void WalkPlayerTo(NavMesh*, Vector2);
+	void StopPlayer(void);
 	void MovePlayer();
 
+	//----------------------------------------------------------------------------------
+	// Scene Objects Functions Declaration
+	//----------------------------------------------------------------------------------
+	void LoadSceneObjects(SceneObjects*, int capacity);
+	void UnloadSceneObjects(SceneObjects*);		// Releases the sprites of every object too
+	int AddSceneObject(SceneObjects*, Animation, Vector2 position, Vector2 size, Vector2 scale, unsigned char flags, const char* description);	// Takes the animation's sprite, -1 when full
+	void UpdateSceneObjectBounds(SceneObjects*, int);
+	void AnimateSceneObjects(SceneObjects*);
+	void GetSceneObjectHotspots(const SceneObjects*, Rectangle* bounds);	// Taken objects get an empty rectangle
+	bool IsPointOnSceneObject(const SceneObjects*, int, Vector2);
+	int PickSceneObject(SceneObjects*, const HotspotGrid*, Vector2);	// Topmost object under the point, -1 if none, reused until either changes
+	void SubmitSceneObjects(const SceneObjects*, RenderLayer);
+
 	//----------------------------------------------------------------------------------
 	// Forest Scene Functions Declaration
 	//----------------------------------------------------------------------------------
 	void InitForestScene(Font);
+	const char** GetForestSceneImages(int*);
 	void UpdateForestScene(void);
 	void DrawForestScene(Font);
 	void UnloadForestScene(void);
@@ -113,6 +153,7 @@ extern "C" {            // Prevents name mangling of functions
 	// Ruins Scene Functions Declaration
 	//----------------------------------------------------------------------------------
 	void InitRuinsScene(Font);
+	const char** GetRuinsSceneImages(int*);
 	void UpdateRuinsScene(void);
 	void DrawRuinsScene(Font);
 	void UnloadRuinsScene(void);
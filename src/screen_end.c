@@ -25,6 +25,9 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "render.h"
+#include "input.h"
+#include "draw_recorder.h"      // Draw calls are captured instead with DRAW_RECORDER defined
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -50,7 +53,7 @@ void UpdateEndingScreen(void)
     // TODO: Update ENDING screen variables here!
 
     // Press enter or tap to return to TITLE screen
-    if (IsKeyPressed(KEY_ENTER) || IsGestureDetected(GESTURE_TAP))
+    if (IsInputKeyPressed(KEY_ENTER) || IsInputTapped())
     {
         finishScreen = 1;
     }
@@ -61,7 +64,7 @@ void DrawEndingScreen(void)
 {
     // TODO: Draw ENDING screen here!
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), BLUE);
-    DrawTextEx(font, "ENDING SCREEN", (Vector2) { 20, 10 }, font.baseSize * 3, 4, DARKBLUE);
+    DrawLabel("ENDING SCREEN", (Vector2) { 20, 10 }, font.baseSize * 3, 4, DARKBLUE);
     DrawText("PRESS ENTER or TAP to RETURN to TITLE SCREEN", 120, 220, 20, DARKBLUE);
 }
 
@@ -0,0 +1,405 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Text: one font for every text size in the game.
+*
+*   With a TrueType font the glyphs are signed distance fields, rendered at any size from a
+*   single atlas by one shader. The atlas starts with printable ASCII and grows when a string
+*   uses a codepoint it does not have yet: every glyph first seen in a frame is added by one
+*   atlas rebuild on the next UpdateGameFont(), and PreloadGameText() queues whole string
+*   tables up front. Without one, the bitmap font is used as before.
+*
+*   The font keeps the bitmap font's baseSize either way, sizes in the game are multiples of
+*   it. SDF glyph metrics are at FONT_SDF_SIZE and scaled from there.
+*
+*   Either way glyph metrics live in a lookup table, so measuring and drawing a string does
+*   not search the glyph list for every codepoint like MeasureTextEx()/DrawTextEx() do.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "text.h"
+#include "draw_recorder.h"
+
+#include <string.h>
+
+#define GLYPH_TABLE_SIZE 1024       // Power of two, non ASCII codepoints, open addressing
+#define MAX_PENDING_GLYPHS 64
+
+typedef struct GlyphMetrics
+{
+    int index;                      // Into font.glyphs/font.recs
+    float drawAdvance;              // As used by DrawTextEx()
+    float measureAdvance;           // As used by MeasureTextEx()
+} GlyphMetrics;
+
+typedef struct GlyphSlot
+{
+    int codepoint;                  // 0 is empty
+    GlyphMetrics metrics;
+} GlyphSlot;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//---------------------------------------------------------------------------------
+static Font gameFont = { 0 };
+static float glyphSize = 0.0f;              // Size glyph metrics are in, baseSize for the bitmap font
+static bool sdf = false;
+static Shader sdfShader = { 0 };
+static int textRun = 0;                     // Nested BeginGameText() calls
+
+static unsigned char* fontData = NULL;      // TrueType data, kept to generate glyphs later
+static unsigned int fontDataSize = 0;
+static GlyphInfo glyphs[MAX_FONT_GLYPHS] = { 0 };
+static Rectangle recs[MAX_FONT_GLYPHS] = { 0 };
+
+static GlyphMetrics asciiGlyphs[128] = { 0 };
+static GlyphSlot glyphTable[GLYPH_TABLE_SIZE] = { 0 };
+static GlyphMetrics fallbackGlyph = { 0 };
+
+static int pendingGlyphs[MAX_PENDING_GLYPHS] = { 0 };
+static int pendingCount = 0;
+
+#if defined(PLATFORM_WEB)
+static const char* sdfFragmentShader =
+    "#version 100\n"
+    "#extension GL_OES_standard_derivatives : enable\n"
+    "precision mediump float;\n"
+    "varying vec2 fragTexCoord;\n"
+    "varying vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "void main()\n"
+    "{\n"
+    "    float distance = texture2D(texture0, fragTexCoord).a - 0.5;\n"
+    "    float width = length(vec2(dFdx(distance), dFdy(distance)));\n"
+    "    gl_FragColor = vec4(fragColor.rgb, fragColor.a*smoothstep(-width, width, distance));\n"
+    "}\n";
+#else
+static const char* sdfFragmentShader =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "out vec4 finalColor;\n"
+    "void main()\n"
+    "{\n"
+    "    float distance = texture(texture0, fragTexCoord).a - 0.5;\n"
+    "    float width = length(vec2(dFdx(distance), dFdy(distance)));\n"
+    "    finalColor = vec4(fragColor.rgb, fragColor.a*smoothstep(-width, width, distance));\n"
+    "}\n";
+#endif
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+static GlyphMetrics ComputeMetrics(int index)
+{
+    GlyphMetrics metrics = { index, 0, 0 };
+    GlyphInfo* glyph = &gameFont.glyphs[index];
+    Rectangle rec = gameFont.recs[index];
+
+    metrics.drawAdvance = (glyph->advanceX != 0) ? (float)glyph->advanceX : rec.width;
+    metrics.measureAdvance = (glyph->advanceX != 0) ? (float)glyph->advanceX : rec.width + glyph->offsetX;
+
+    return metrics;
+}
+
+static void BuildGlyphTable(void)
+{
+    memset(asciiGlyphs, 0, sizeof(asciiGlyphs));
+    memset(glyphTable, 0, sizeof(glyphTable));
+    for (int i = 0; i < 128; ++i) asciiGlyphs[i].index = -1;
+
+    for (int i = 0; i < gameFont.glyphCount; ++i)
+    {
+        int codepoint = gameFont.glyphs[i].value;
+
+        if (codepoint >= 0 && codepoint < 128) asciiGlyphs[codepoint] = ComputeMetrics(i);
+        else if (codepoint > 0)
+        {
+            unsigned int slot = (unsigned int)codepoint & (GLYPH_TABLE_SIZE - 1);
+            while (glyphTable[slot].codepoint != 0) slot = (slot + 1) & (GLYPH_TABLE_SIZE - 1);
+            glyphTable[slot].codepoint = codepoint;
+            glyphTable[slot].metrics = ComputeMetrics(i);
+        }
+    }
+
+    // Same fallback as GetGlyphIndex(): '?' when there is one, first glyph otherwise
+    fallbackGlyph = (asciiGlyphs['?'].index >= 0) ? asciiGlyphs['?'] : ComputeMetrics(0);
+}
+
+static void QueueGlyph(int codepoint)
+{
+    if (!sdf || pendingCount == MAX_PENDING_GLYPHS) return;
+
+    for (int i = 0; i < pendingCount; ++i)
+    {
+        if (pendingGlyphs[i] == codepoint) return;
+    }
+
+    pendingGlyphs[pendingCount++] = codepoint;
+}
+
+static GlyphMetrics LookupGlyph(int codepoint)
+{
+    if (codepoint >= 0 && codepoint < 128)
+    {
+        if (asciiGlyphs[codepoint].index >= 0) return asciiGlyphs[codepoint];
+    }
+    else
+    {
+        unsigned int slot = (unsigned int)codepoint & (GLYPH_TABLE_SIZE - 1);
+        while (glyphTable[slot].codepoint != 0)
+        {
+            if (glyphTable[slot].codepoint == codepoint) return glyphTable[slot].metrics;
+            slot = (slot + 1) & (GLYPH_TABLE_SIZE - 1);
+        }
+    }
+
+    QueueGlyph(codepoint);
+    return fallbackGlyph;
+}
+
+static void RebuildAtlas(void)
+{
+    Rectangle* packed = NULL;
+    Image atlas = GenImageFontAtlas(glyphs, &packed, gameFont.glyphCount, FONT_SDF_SIZE, 0, 1);
+
+    memcpy(recs, packed, gameFont.glyphCount * sizeof(Rectangle));
+    MemFree(packed);
+
+    if (gameFont.texture.id != 0) UnloadTexture(gameFont.texture);
+    gameFont.texture = LoadTextureFromImage(atlas);
+    SetTextureFilter(gameFont.texture, TEXTURE_FILTER_BILINEAR);    // Required by distance fields
+    UnloadImage(atlas);
+
+    BuildGlyphTable();
+}
+
+// Bitmap font next to the TrueType one, i.e. "data/pixantiqua.ttf" -> "data/pixantiqua.png"
+static const char* BitmapFontFile(const char* fileName)
+{
+    return TextFormat("%s/%s.png", GetDirectoryPath(fileName), GetFileNameWithoutExt(fileName));
+}
+
+static int AddGlyphs(int* codepoints, int count)
+{
+    count = (gameFont.glyphCount + count <= MAX_FONT_GLYPHS) ? count : MAX_FONT_GLYPHS - gameFont.glyphCount;
+    if (count <= 0) return 0;
+
+    GlyphInfo* added = LoadFontData(fontData, (int)fontDataSize, FONT_SDF_SIZE, codepoints, count, FONT_SDF);
+    if (added == NULL) return 0;
+
+    // NOTE: Glyph images now belong to glyphs[], only the array itself is freed
+    memcpy(&glyphs[gameFont.glyphCount], added, count * sizeof(GlyphInfo));
+    MemFree(added);
+    gameFont.glyphCount += count;
+
+    return count;
+}
+
+//----------------------------------------------------------------------------------
+// Text Functions Definition
+//----------------------------------------------------------------------------------
+Font LoadGameFont(const char* fileName)
+{
+    UnloadGameFont();
+
+    if (IsFileExtension(fileName, ".ttf;.otf")) fontData = LoadFileData(fileName, &fontDataSize);
+
+    if (fontData != NULL)
+    {
+        // Text sizes are multiples of the bitmap font size, loaded once to keep laying out the same
+        int baseSize = FONT_SDF_SIZE;
+        const char* bitmapFile = BitmapFontFile(fileName);
+        if (FileExists(bitmapFile))
+        {
+            Font bitmap = LoadFont(bitmapFile);
+            if (bitmap.baseSize > 0) baseSize = bitmap.baseSize;
+            UnloadFont(bitmap);
+        }
+
+        sdf = true;
+        glyphSize = FONT_SDF_SIZE;
+        gameFont.baseSize = baseSize;
+        gameFont.glyphPadding = 0;
+        gameFont.glyphs = glyphs;
+        gameFont.recs = recs;
+
+        int ascii[95];
+        for (int i = 0; i < 95; ++i) ascii[i] = 32 + i;
+        AddGlyphs(ascii, 95);
+
+        RebuildAtlas();
+        sdfShader = LoadShaderFromMemory(NULL, sdfFragmentShader);
+
+        TraceLog(LOG_INFO, "TEXT: [%s] SDF font, %i glyphs", fileName, gameFont.glyphCount);
+    }
+    else
+    {
+        gameFont = LoadFont(BitmapFontFile(fileName));
+        glyphSize = (float)gameFont.baseSize;
+        BuildGlyphTable();
+    }
+
+    return gameFont;
+}
+
+void UnloadGameFont(void)
+{
+    if (sdf)
+    {
+        for (int i = 0; i < gameFont.glyphCount; ++i) UnloadImage(glyphs[i].image);
+        UnloadTexture(gameFont.texture);
+        UnloadShader(sdfShader);
+        UnloadFileData(fontData);
+    }
+    else if (gameFont.texture.id != 0) UnloadFont(gameFont);
+
+    gameFont = (Font){ 0 };
+    glyphSize = 0.0f;
+    sdf = false;
+    textRun = 0;
+    sdfShader = (Shader){ 0 };
+    fontData = NULL;
+    fontDataSize = 0;
+    pendingCount = 0;
+}
+
+Font GetGameFont(void)
+{
+    return gameFont;
+}
+
+bool UpdateGameFont(void)
+{
+    if (pendingCount == 0) return false;
+
+    int added = AddGlyphs(pendingGlyphs, pendingCount);
+    pendingCount = 0;
+
+    if (added > 0) RebuildAtlas();
+
+    return added > 0;
+}
+
+void PreloadGameText(const char* text, int length)
+{
+    // Looking a glyph up queues it when missing
+    for (int i = 0; i < length;)
+    {
+        int bytes = 0;
+        int codepoint = GetCodepoint(&text[i], &bytes);
+        if (codepoint != 0) LookupGlyph(codepoint);
+        i += (bytes > 0) ? bytes : 1;
+    }
+}
+
+Vector2 MeasureGameText(const char* text, float fontSize, float spacing)
+{
+    // Same result as MeasureTextEx()
+    float scaleFactor = fontSize / glyphSize;
+    float textWidth = 0.0f;
+    float maxWidth = 0.0f;
+    float textHeight = glyphSize;
+    int lineCodepoints = 0;
+    int maxCodepoints = 0;
+
+    for (int i = 0; text[i] != '\0';)
+    {
+        int bytes = 0;
+        int codepoint = GetCodepoint(&text[i], &bytes);
+        if (codepoint == 0x3f) bytes = 1;
+        i += bytes;
+
+        lineCodepoints += 1;
+
+        if (codepoint != '\n') textWidth += LookupGlyph(codepoint).measureAdvance;
+        else
+        {
+            if (maxWidth < textWidth) maxWidth = textWidth;
+            lineCodepoints = 0;
+            textWidth = 0.0f;
+            textHeight += glyphSize * 1.5f;
+        }
+
+        if (maxCodepoints < lineCodepoints) maxCodepoints = lineCodepoints;
+    }
+
+    if (maxWidth < textWidth) maxWidth = textWidth;
+
+    return (Vector2){ maxWidth * scaleFactor + (float)((maxCodepoints - 1) * spacing), textHeight * scaleFactor };
+}
+
+void BeginGameText(void)
+{
+    if (sdf && (textRun == 0)) BeginShaderMode(sdfShader);
+    textRun += 1;
+}
+
+void EndGameText(void)
+{
+    textRun -= 1;
+    if (sdf && (textRun == 0)) EndShaderMode();
+}
+
+bool IsGameTextShaded(void)
+{
+    return sdf;
+}
+
+// 0 for raylib's default shader or any other, the SDF text shader is the only one the game loads
+unsigned int GetShaderIdentity(Shader shader)
+{
+    return ((shader.id != 0) && (shader.id == sdfShader.id)) ? 1 : 0;
+}
+
+void DrawGameText(const char* text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    // Same layout as DrawTextEx()
+    float scaleFactor = fontSize / glyphSize;
+    float padding = (float)gameFont.glyphPadding;
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+
+    BeginGameText();
+
+    for (int i = 0; text[i] != '\0';)
+    {
+        int bytes = 0;
+        int codepoint = GetCodepoint(&text[i], &bytes);
+        if (codepoint == 0x3f) bytes = 1;
+        i += bytes;
+
+        if (codepoint == '\n')
+        {
+            offsetY += (int)((glyphSize + (int)glyphSize / 2) * scaleFactor);
+            offsetX = 0.0f;
+            continue;
+        }
+
+        GlyphMetrics metrics = LookupGlyph(codepoint);
+
+        if (codepoint != ' ' && codepoint != '\t')
+        {
+            GlyphInfo* glyph = &gameFont.glyphs[metrics.index];
+            Rectangle rec = gameFont.recs[metrics.index];
+            Rectangle source = { rec.x - padding, rec.y - padding, rec.width + 2.0f * padding, rec.height + 2.0f * padding };
+            Rectangle dest = {
+                position.x + offsetX + (glyph->offsetX - padding) * scaleFactor,
+                position.y + offsetY + (glyph->offsetY - padding) * scaleFactor,
+                source.width * scaleFactor,
+                source.height * scaleFactor
+            };
+
+            DrawTexturePro(gameFont.texture, source, dest, (Vector2){ 0 }, 0.0f, tint);
+        }
+
+        offsetX += metrics.drawAdvance * scaleFactor + spacing;
+    }
+
+    EndGameText();
+}
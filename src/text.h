@@ -0,0 +1,38 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define FONT_SDF_SIZE 32			// Glyph size distance fields are generated at
+#define MAX_FONT_GLYPHS 512
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Text Functions Declaration
+	//----------------------------------------------------------------------------------
+	Font LoadGameFont(const char* fileName);	// SDF font from .ttf/.otf, bitmap font otherwise
+	void UnloadGameFont(void);
+	Font GetGameFont(void);					// Current font, the atlas changes as glyphs are added
+	bool UpdateGameFont(void);				// Add glyphs first seen last frame, call outside drawing
+	void PreloadGameText(const char* text, int length);	// Queue missing glyphs of length bytes of strings, '\0' separated or not
+	Vector2 MeasureGameText(const char* text, float fontSize, float spacing);
+	void DrawGameText(const char* text, Vector2 position, float fontSize, float spacing, Color tint);
+
+	// An SDF font draws through a shader, and switching shader flushes raylib's batch. Draw
+	// runs of text between these to switch once, DrawGameText() switches on its own otherwise.
+	void BeginGameText(void);
+	void EndGameText(void);
+	bool IsGameTextShaded(void);			// Text switches shader, see above
+	unsigned int GetShaderIdentity(Shader shader);	// Which game shader it is, unlike the GL id the same on every machine
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEXT_H
@@ -0,0 +1,257 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Text cache: strings that stay on screen for many frames (hover descriptions, dialogue,
+*   menu strings) are rendered once into a shared render texture and drawn as one quad
+*   afterwards, instead of laying out and drawing every glyph every frame.
+*
+*   A string is keyed by its text, size, spacing and color. On a miss it is drawn glyph by
+*   glyph as before and queued, UpdateTextCache() renders it before the next frame draws.
+*   Rendering happens outside BeginDrawing() so it never has to interrupt a render target or
+*   camera the caller may have active.
+*
+*   The string is drawn with the MAX blend equation over a band cleared to its own color with
+*   zero alpha. With a single color per string that writes exactly the color and coverage the
+*   glyphs have, so the cached quad blends onto the scene the same as the glyphs did.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "text_cache.h"
+#include "text.h"
+
+#include <math.h>
+#include <string.h>
+
+#define TEXT_CACHE_PADDING 4            // Glyphs may overhang the measured size a little
+#define TEXT_BLEND_ONE 1                // GL_ONE, rlSetBlendFactors() takes raw GL values
+#define TEXT_BLEND_MAX 0x8008           // GL_MAX
+
+// NOTE: From rlgl.h, which include/ does not ship, the function is exported by raylib itself
+void rlSetBlendFactors(int glSrcFactor, int glDstFactor, int glEquation);
+
+typedef struct CachedText
+{
+    char text[MAX_CACHED_TEXT_LENGTH];  // Empty when the entry is free
+    float fontSize;
+    float spacing;
+    Color tint;
+    TextCacheGroup group;
+    Rectangle region;                   // In render texture drawing coordinates
+    bool ready;                         // Rendered, otherwise queued for UpdateTextCache()
+} CachedText;
+
+// Shelf packer state of one group band
+typedef struct TextBand
+{
+    int top;
+    int bottom;
+    int cursorX;
+    int cursorY;
+    int shelfHeight;
+} TextBand;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//---------------------------------------------------------------------------------
+static RenderTexture2D target = { 0 };
+static CachedText texts[MAX_CACHED_TEXTS] = { 0 };
+static TextBand bands[TEXT_GROUP_COUNT] = { 0 };
+static TextCacheGroup currentGroup = TEXT_GROUP_UI;
+static TextCacheStats stats = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+static bool SameColor(Color a, Color b)
+{
+    return (a.r == b.r) && (a.g == b.g) && (a.b == b.b) && (a.a == b.a);
+}
+
+static CachedText* FindText(const char* text, float fontSize, float spacing, Color tint)
+{
+    for (int i = 0; i < MAX_CACHED_TEXTS; ++i)
+    {
+        CachedText* entry = &texts[i];
+
+        if (entry->text[0] == '\0' || entry->fontSize != fontSize || entry->spacing != spacing) continue;
+        if (SameColor(entry->tint, tint) && strcmp(entry->text, text) == 0) return entry;
+    }
+
+    return NULL;
+}
+
+static CachedText* FreeText(void)
+{
+    for (int i = 0; i < MAX_CACHED_TEXTS; ++i)
+    {
+        if (texts[i].text[0] == '\0') return &texts[i];
+    }
+
+    return NULL;
+}
+
+// Place a width x height region in the group band, false if the band is full
+static bool PackRegion(TextBand* band, int width, int height, Rectangle* region)
+{
+    if (width > TEXT_CACHE_WIDTH) return false;
+
+    if (band->cursorX + width > TEXT_CACHE_WIDTH)
+    {
+        band->cursorX = 0;
+        band->cursorY += band->shelfHeight;
+        band->shelfHeight = 0;
+    }
+
+    if (band->cursorY + height > band->bottom) return false;
+
+    *region = (Rectangle){ (float)band->cursorX, (float)band->cursorY, (float)width, (float)height };
+
+    band->cursorX += width;
+    if (height > band->shelfHeight) band->shelfHeight = height;
+
+    return true;
+}
+
+static void QueueText(const char* text, float fontSize, float spacing, Color tint)
+{
+    Vector2 size = MeasureGameText(text, fontSize, spacing);
+    int width = (int)ceilf(size.x) + 2 * TEXT_CACHE_PADDING;
+    int height = (int)ceilf(size.y) + 2 * TEXT_CACHE_PADDING;
+
+    // Entry first, band space taken for a string that then has no entry is never given back
+    CachedText* entry = FreeText();
+    if (entry == NULL) return;
+
+    Rectangle region = { 0 };
+    if (!PackRegion(&bands[currentGroup], width, height, &region))
+    {
+        // Band full, start it over, strings still in use are simply cached again
+        EvictTextCacheGroup(currentGroup);
+        if (!PackRegion(&bands[currentGroup], width, height, &region)) return;
+    }
+
+    strcpy(entry->text, text);
+    entry->fontSize = fontSize;
+    entry->spacing = spacing;
+    entry->tint = tint;
+    entry->group = currentGroup;
+    entry->region = region;
+    entry->ready = false;
+}
+
+//----------------------------------------------------------------------------------
+// Text Cache Functions Definition
+//----------------------------------------------------------------------------------
+void LoadTextCache(void)
+{
+    target = LoadRenderTexture(TEXT_CACHE_WIDTH, TEXT_CACHE_HEIGHT);
+
+    for (int i = 0; i < TEXT_GROUP_COUNT; ++i)
+    {
+        bands[i] = (TextBand){ 0 };
+        bands[i].top = i * TEXT_CACHE_HEIGHT / TEXT_GROUP_COUNT;
+        bands[i].bottom = (i + 1) * TEXT_CACHE_HEIGHT / TEXT_GROUP_COUNT;
+        bands[i].cursorY = bands[i].top;
+    }
+
+    for (int i = 0; i < MAX_CACHED_TEXTS; ++i) texts[i] = (CachedText){ 0 };
+
+    currentGroup = TEXT_GROUP_UI;
+    stats = (TextCacheStats){ 0 };
+}
+
+void UnloadTextCache(void)
+{
+    if (target.id != 0) UnloadRenderTexture(target);
+    target = (RenderTexture2D){ 0 };
+}
+
+void UpdateTextCache(void)
+{
+    bool anyPending = false;
+    for (int i = 0; i < MAX_CACHED_TEXTS; ++i) anyPending |= (texts[i].text[0] != '\0' && !texts[i].ready);
+    if (!anyPending || target.id == 0) return;
+
+    BeginTextureMode(target);
+    rlSetBlendFactors(TEXT_BLEND_ONE, TEXT_BLEND_ONE, TEXT_BLEND_MAX);
+    BeginBlendMode(BLEND_CUSTOM);
+    BeginGameText();
+
+    for (int i = 0; i < MAX_CACHED_TEXTS; ++i)
+    {
+        CachedText* entry = &texts[i];
+        if (entry->text[0] == '\0' || entry->ready) continue;
+
+        Rectangle region = entry->region;
+
+        BeginScissorMode((int)region.x, (int)region.y, (int)region.width, (int)region.height);
+        ClearBackground((Color){ entry->tint.r, entry->tint.g, entry->tint.b, 0 });
+        EndScissorMode();
+
+        Vector2 position = { region.x + TEXT_CACHE_PADDING, region.y + TEXT_CACHE_PADDING };
+        DrawGameText(entry->text, position, entry->fontSize, entry->spacing, entry->tint);
+
+        entry->ready = true;
+        stats.rendered += 1;
+    }
+
+    EndGameText();
+    EndBlendMode();
+    EndTextureMode();
+}
+
+void SetTextCacheGroup(TextCacheGroup group)
+{
+    currentGroup = group;
+}
+
+bool FindCachedText(const char* text, float fontSize, float spacing, Color tint, Texture2D* texture, Rectangle* source, Vector2* offset)
+{
+    if (target.id == 0 || text[0] == '\0' || strlen(text) >= MAX_CACHED_TEXT_LENGTH) return false;
+
+    CachedText* entry = FindText(text, fontSize, spacing, tint);
+
+    if (entry == NULL || !entry->ready)
+    {
+        if (entry == NULL) QueueText(text, fontSize, spacing, tint);
+        stats.misses += 1;
+        return false;
+    }
+
+    // NOTE: Render textures are stored upside down, the region is flipped with a negative height
+    Rectangle region = entry->region;
+    *texture = target.texture;
+    *source = (Rectangle){ region.x, TEXT_CACHE_HEIGHT - region.y - region.height, region.width, -region.height };
+    *offset = (Vector2){ -TEXT_CACHE_PADDING, -TEXT_CACHE_PADDING };
+
+    stats.hits += 1;
+    return true;
+}
+
+void EvictTextCacheGroup(TextCacheGroup group)
+{
+    for (int i = 0; i < MAX_CACHED_TEXTS; ++i)
+    {
+        if (texts[i].text[0] != '\0' && texts[i].group == group)
+        {
+            texts[i] = (CachedText){ 0 };
+            stats.evicted += 1;
+        }
+    }
+
+    bands[group].cursorX = 0;
+    bands[group].cursorY = bands[group].top;
+    bands[group].shelfHeight = 0;
+}
+
+TextCacheStats GetTextCacheStats(void)
+{
+    stats.cachedTexts = 0;
+    for (int i = 0; i < MAX_CACHED_TEXTS; ++i) stats.cachedTexts += (texts[i].text[0] != '\0');
+
+    return stats;
+}
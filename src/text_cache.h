@@ -0,0 +1,50 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define TEXT_CACHE_WIDTH 1024
+#define TEXT_CACHE_HEIGHT 1024			// Split evenly between the groups
+#define MAX_CACHED_TEXTS 128
+#define MAX_CACHED_TEXT_LENGTH 256		// Longer strings are drawn glyph by glyph every time
+
+// Each group packs into its own band of the cache texture and is evicted as a whole
+typedef enum TextCacheGroup
+{
+	TEXT_GROUP_UI = 0,		// Hover descriptions and menu strings, evicted only when the band is full
+	TEXT_GROUP_DIALOGUE,	// Evicted when the dialogue closes
+	TEXT_GROUP_COUNT
+} TextCacheGroup;
+
+typedef struct TextCacheStats
+{
+	int hits;				// Strings drawn as a single quad
+	int misses;				// Strings drawn glyph by glyph while their render is pending
+	int rendered;
+	int evicted;
+	int cachedTexts;
+} TextCacheStats;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Text Cache Functions Declaration
+	//----------------------------------------------------------------------------------
+	void LoadTextCache(void);
+	void UnloadTextCache(void);
+	void UpdateTextCache(void);				// Render strings missed since last call, outside drawing
+	void SetTextCacheGroup(TextCacheGroup group);	// Group strings missed from now on are cached in
+	bool FindCachedText(const char* text, float fontSize, float spacing, Color tint, Texture2D* texture, Rectangle* source, Vector2* offset);	// Queues the string on a miss
+	void EvictTextCacheGroup(TextCacheGroup group);
+	TextCacheStats GetTextCacheStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEXT_CACHE_H
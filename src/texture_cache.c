@@ -0,0 +1,546 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Texture cache: textures are keyed by file path and reference counted, so a texture
+*   shared by several scenes (or held by the inventory) stays resident across ChangeScene.
+*
+*   Resident bytes are kept under a budget instead of unloading on every scene change.
+*   UpdateTextureCache() evicts the least recently drawn textures, released or not, once
+*   the budget is exceeded. Scenes hold handles rather than textures, so an evicted texture
+*   is simply loaded again the next time UseTexture() is asked for it. Whatever was drawn
+*   last frame is never evicted, the current scene may go over budget on its own.
+*
+*   Hit masks are baked at scene load for the sprites a scene makes clickable, backgrounds
+*   and other art nobody clicks never pay for one. A mask outlives eviction, picking never
+*   needs the texture or its image.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "texture_cache.h"
+#include "asset_prefetch.h"
+#include "asset_pack.h"
+#include "hit_mask.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+typedef struct CachedTexture
+{
+    char fileName[MAX_TEXTURE_PATH];    // Empty when the slot is free
+    Texture2D texture;          // Id 0 while evicted
+    float scale;                // Below 1 when loaded from a downscaled variant
+    int references;
+    unsigned int lastUsed;      // Frame it was last drawn or loaded in
+    HitMask mask;               // Kept while the slot is, texture pixels
+    bool maskBaked;             // Tried once, by BakeSpriteHitMask()
+} CachedTexture;
+
+typedef struct AtlasFrame
+{
+    char fileName[MAX_TEXTURE_PATH];
+    Rectangle region;           // Whole sheet, tables written before trimming
+    int firstTrim;              // Trimmed sheets, frameCount trims from here
+    int frameCount;
+    Vector2 frameSize;
+} AtlasFrame;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//---------------------------------------------------------------------------------
+static CachedTexture cache[MAX_CACHED_TEXTURES] = { 0 };
+static TextureCacheStats stats = { .budgetBytes = TEXTURE_BUDGET_BYTES };
+static unsigned int frame = 1;
+
+static char atlasFile[MAX_TEXTURE_PATH] = { 0 };
+static AtlasFrame atlasFrames[MAX_ATLAS_FRAMES] = { 0 };
+static int atlasFrameCount = 0;
+static SpriteTrim atlasTrims[MAX_ATLAS_TRIMS] = { 0 };
+static int atlasTrimCount = 0;
+
+static char variantDirectory[MAX_TEXTURE_PATH] = { 0 };
+static float variantScale = 1.0f;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+static int TextureBytes(Texture2D texture)
+{
+    return GetPixelDataSize(texture.width, texture.height, texture.format);
+}
+
+// Free the slot
+static void ClearEntry(CachedTexture* entry)
+{
+    UnloadHitMask(&entry->mask);
+    *entry = (CachedTexture){ 0 };
+}
+
+static CachedTexture* GetEntry(TextureHandle handle)
+{
+    if (handle <= 0 || handle > MAX_CACHED_TEXTURES) return NULL;
+
+    return &cache[handle - 1];
+}
+
+// Least recently used resident texture that was not drawn last frame, raylib may not
+// have flushed a batch using it yet when it is evicted in the same frame
+static CachedTexture* FindEvictable(bool unreferencedOnly)
+{
+    CachedTexture* oldest = NULL;
+
+    for (int i = 0; i < MAX_CACHED_TEXTURES; ++i)
+    {
+        CachedTexture* entry = &cache[i];
+
+        if (entry->texture.id == 0 || entry->lastUsed + 1 >= frame) continue;
+        if (unreferencedOnly && entry->references > 0) continue;
+
+        if (oldest == NULL || entry->lastUsed < oldest->lastUsed) oldest = entry;
+    }
+
+    return oldest;
+}
+
+static const AtlasFrame* FindAtlasFrame(const char* fileName)
+{
+    for (int i = 0; i < atlasFrameCount; ++i)
+    {
+        if (strcmp(atlasFrames[i].fileName, fileName) == 0) return &atlasFrames[i];
+    }
+
+    return NULL;
+}
+
+// Variant of a file in the chosen variant directory, i.e. "data/bg.png" -> "data/1x/bg.png"
+static const char* FindVariantFile(const char* fileName)
+{
+    static char variant[MAX_TEXTURE_PATH] = { 0 };
+
+    if (variantDirectory[0] == '\0') return NULL;
+
+    const char* name = strrchr(fileName, '/');
+    int directoryLength = (name != NULL) ? (int)(name - fileName) : 0;
+    name = (name != NULL) ? name + 1 : fileName;
+
+    int length = 0;
+    if (directoryLength > 0) length = snprintf(variant, sizeof(variant), "%.*s/%s/%s", directoryLength, fileName, variantDirectory, name);
+    else length = snprintf(variant, sizeof(variant), "%s/%s", variantDirectory, name);
+
+    // A truncated path could name some other file
+    if ((length < 0) || (length >= (int)sizeof(variant))) return NULL;
+
+    unsigned int size = 0;
+    if (GetPackedFile(variant, &size) != NULL || FileExists(variant)) return variant;
+
+    return NULL;
+}
+
+static bool LoadEntry(CachedTexture* entry)
+{
+    const char* variant = FindVariantFile(entry->fileName);
+    const char* loadFile = (variant != NULL) ? variant : entry->fileName;
+    float scale = (variant != NULL) ? variantScale : 1.0f;
+
+    Texture2D texture = { 0 };
+    Image image = { 0 };
+
+    // Prefetch worker may have decoded it already, then only the upload is left
+    double start = GetTime();
+    if (!TakePrefetchedImage(loadFile, &image))
+    {
+        image = LoadImagePacked(loadFile);
+        stats.loadSeconds += GetTime() - start;
+        start = GetTime();
+    }
+
+    if (image.data != NULL)
+    {
+        texture = LoadTextureFromImage(image);
+        UnloadImage(image);
+        stats.uploadSeconds += GetTime() - start;
+    }
+
+    if (texture.id == 0) return false;
+
+    if (variant != NULL)
+    {
+        int fullBytes = GetPixelDataSize((int)(texture.width / scale), (int)(texture.height / scale), texture.format);
+        stats.savedBytes += fullBytes - TextureBytes(texture);
+    }
+
+    entry->texture = texture;
+    entry->scale = scale;
+    entry->lastUsed = frame;
+
+    stats.residentTextures += 1;
+    stats.residentBytes += TextureBytes(texture);
+
+    return true;
+}
+
+// Unload the texture, the slot stays with its file name while someone holds a handle
+static void EvictEntry(CachedTexture* entry)
+{
+    stats.residentTextures -= 1;
+    stats.residentBytes -= TextureBytes(entry->texture);
+    stats.unloaded += 1;
+
+    UnloadTexture(entry->texture);
+    entry->texture = (Texture2D){ 0 };
+
+    if (entry->references == 0) ClearEntry(entry);
+}
+
+//----------------------------------------------------------------------------------
+// Texture Cache Functions Definition
+//----------------------------------------------------------------------------------
+TextureHandle AcquireTexture(const char* fileName)
+{
+    CachedTexture* freeEntry = NULL;
+
+    for (int i = 0; i < MAX_CACHED_TEXTURES; ++i)
+    {
+        if (cache[i].fileName[0] == '\0')
+        {
+            if (freeEntry == NULL) freeEntry = &cache[i];
+        }
+        else if (strcmp(cache[i].fileName, fileName) == 0)
+        {
+            if (cache[i].texture.id != 0) stats.hits += 1;
+            else if (LoadEntry(&cache[i])) stats.misses += 1;     // Evicted, but still has a slot
+
+            cache[i].references += 1;
+            return i + 1;
+        }
+    }
+
+    if (strlen(fileName) >= MAX_TEXTURE_PATH)
+    {
+        TraceLog(LOG_WARNING, "TEXCACHE: [%s] Not loaded, path too long", fileName);
+        return 0;
+    }
+
+    // All slots taken, make room by evicting a released texture
+    if (freeEntry == NULL)
+    {
+        freeEntry = FindEvictable(true);
+        if (freeEntry != NULL) EvictEntry(freeEntry);
+    }
+
+    if (freeEntry == NULL)
+    {
+        TraceLog(LOG_WARNING, "TEXCACHE: [%s] Not loaded, cache full", fileName);
+        return 0;
+    }
+
+    stats.misses += 1;
+
+    strcpy(freeEntry->fileName, fileName);
+    if (!LoadEntry(freeEntry))
+    {
+        ClearEntry(freeEntry);
+        return 0;
+    }
+
+    freeEntry->references = 1;
+    return (TextureHandle)(freeEntry - cache) + 1;
+}
+
+void RetainTexture(TextureHandle texture)
+{
+    CachedTexture* entry = GetEntry(texture);
+    if (entry != NULL && entry->fileName[0] != '\0') entry->references += 1;
+}
+
+void ReleaseTexture(TextureHandle texture)
+{
+    CachedTexture* entry = GetEntry(texture);
+    if (entry == NULL || entry->references == 0) return;
+
+    entry->references -= 1;
+
+    // Nothing left to reload it for
+    if (entry->references == 0 && entry->texture.id == 0) ClearEntry(entry);
+}
+
+Texture2D UseTexture(TextureHandle texture)
+{
+    CachedTexture* entry = GetEntry(texture);
+    if (entry == NULL || entry->fileName[0] == '\0') return (Texture2D){ 0 };
+
+    if (entry->texture.id == 0 && LoadEntry(entry)) stats.reloads += 1;
+
+    entry->lastUsed = frame;
+    return entry->texture;
+}
+
+void UpdateTextureCache(void)
+{
+    frame += 1;
+
+    while (stats.residentBytes > stats.budgetBytes)
+    {
+        CachedTexture* oldest = FindEvictable(false);
+        if (oldest == NULL) break;      // Everything left is in use
+
+        EvictEntry(oldest);
+    }
+}
+
+void SetTextureBudget(int bytes)
+{
+    stats.budgetBytes = bytes;
+    TraceLog(LOG_INFO, "TEXCACHE: Texture budget %.2f MB", bytes / (1024.0f * 1024.0f));
+}
+
+void UnloadTextureCache(void)
+{
+    for (int i = 0; i < MAX_CACHED_TEXTURES; ++i)
+    {
+        if (cache[i].texture.id != 0)
+        {
+            cache[i].references = 0;
+            EvictEntry(&cache[i]);
+        }
+
+        ClearEntry(&cache[i]);
+    }
+}
+
+TextureCacheStats GetTextureCacheStats(void)
+{
+    return stats;
+}
+
+void TraceTextureCacheStats(const char* label)
+{
+    TraceLog(LOG_INFO, "TEXCACHE: [%s] %i hits, %i misses, %i unloaded, %i reloads, %i resident (%.2f of %.2f MB), variants saved %.2f MB",
+        label, stats.hits, stats.misses, stats.unloaded, stats.reloads, stats.residentTextures, stats.residentBytes / (1024.0f * 1024.0f),
+        stats.budgetBytes / (1024.0f * 1024.0f), stats.savedBytes / (1024.0f * 1024.0f));
+
+    stats.savedBytes = 0;
+    stats.reloads = 0;
+    stats.hits = 0;
+    stats.misses = 0;
+    stats.unloaded = 0;
+}
+
+bool LoadSpriteAtlas(const char* tableFile)
+{
+    // NOTE: Read through LoadFileData() so the table is served from the asset pack too
+    unsigned int size = 0;
+    unsigned char* data = LoadFileData(tableFile, &size);
+    if (data == NULL) return false;
+
+    char* text = (char*)MemAlloc(size + 1);
+    memcpy(text, data, size);
+    UnloadFileData(data);
+
+    atlasFile[0] = '\0';
+    atlasFrameCount = 0;
+    atlasTrimCount = 0;
+    AtlasFrame* sheet = NULL;       // Trims belong to the sheet line above them, never to a frame line
+
+    for (char* line = strtok(text, "\r\n"); line != NULL; line = strtok(NULL, "\r\n"))
+    {
+        char name[MAX_TEXTURE_PATH] = { 0 };
+        Rectangle region = { 0 };
+        Vector2 offset = { 0 };
+        int frames = 0;
+
+        if (sscanf(line, "atlas %127s", name) == 1) strcpy(atlasFile, name);
+        else if (sscanf(line, "frame %127s %f %f %f %f", name, &region.x, &region.y, &region.width, &region.height) == 5)
+        {
+            if (atlasFrameCount == MAX_ATLAS_FRAMES) break;
+
+            atlasFrames[atlasFrameCount] = (AtlasFrame){ 0 };
+            strcpy(atlasFrames[atlasFrameCount].fileName, name);
+            atlasFrames[atlasFrameCount].region = region;
+            atlasFrameCount += 1;
+            sheet = NULL;
+        }
+        else if (sscanf(line, "sheet %127s %i %f %f", name, &frames, &region.width, &region.height) == 4)
+        {
+            if (atlasFrameCount == MAX_ATLAS_FRAMES) break;
+
+            // Frames are located by dividing by their size
+            if ((frames < 1) || (region.width <= 0.0f) || (region.height <= 0.0f))
+            {
+                TraceLog(LOG_WARNING, "TEXCACHE: [%s] Sheet %s has no frames, not atlased", tableFile, name);
+                sheet = NULL;
+                continue;
+            }
+
+            // Trim lines follow, one per frame
+            sheet = &atlasFrames[atlasFrameCount];
+            *sheet = (AtlasFrame){ 0 };
+            strcpy(sheet->fileName, name);
+            sheet->region = (Rectangle){ 0, 0, region.width * frames, region.height };
+            sheet->firstTrim = atlasTrimCount;
+            sheet->frameSize = (Vector2){ region.width, region.height };
+            atlasFrameCount += 1;
+        }
+        else if (sscanf(line, "trim %f %f %f %f %f %f", &region.x, &region.y, &region.width, &region.height, &offset.x, &offset.y) == 6)
+        {
+            if (atlasTrimCount == MAX_ATLAS_TRIMS) break;
+
+            if (sheet == NULL)
+            {
+                TraceLog(LOG_WARNING, "TEXCACHE: [%s] Trim without a sheet line above it, ignored", tableFile);
+                continue;
+            }
+
+            atlasTrims[atlasTrimCount] = (SpriteTrim){ region, offset };
+            atlasTrimCount += 1;
+            sheet->frameCount += 1;
+        }
+    }
+
+    MemFree(text);
+
+    if (atlasFile[0] == '\0') atlasFrameCount = 0;
+    TraceLog(LOG_INFO, "TEXCACHE: [%s] Sprite atlas with %i frames", atlasFile, atlasFrameCount);
+
+    return atlasFrameCount > 0;
+}
+
+Sprite AcquireSprite(const char* fileName)
+{
+    Sprite sprite = { 0 };
+    const AtlasFrame* frame = FindAtlasFrame(fileName);
+
+    if (frame != NULL)
+    {
+        sprite.texture = AcquireTexture(atlasFile);
+        sprite.region = frame->region;
+        sprite.scale = 1.0f;        // Atlas keeps sprites at their source size
+
+        if (frame->frameCount > 0)
+        {
+            sprite.trims = &atlasTrims[frame->firstTrim];
+            sprite.frameCount = frame->frameCount;
+            sprite.frameSize = frame->frameSize;
+        }
+    }
+    else
+    {
+        sprite.texture = AcquireTexture(fileName);
+
+        CachedTexture* entry = GetEntry(sprite.texture);
+        if (entry != NULL) sprite.region = (Rectangle){ 0, 0, (float)entry->texture.width, (float)entry->texture.height };
+        sprite.scale = GetTextureScale(sprite.texture);
+    }
+
+    return sprite;
+}
+
+void BakeSpriteHitMask(Sprite sprite)
+{
+    CachedTexture* entry = GetEntry(sprite.texture);
+    if ((entry == NULL) || (entry->fileName[0] == '\0') || entry->maskBaked) return;
+
+    // NOTE: The upload already freed its image, so it is decoded again, once per texture
+    const char* variant = FindVariantFile(entry->fileName);
+    Image image = LoadImagePacked((variant != NULL) ? variant : entry->fileName);
+    if (image.data != NULL) entry->mask = BakeHitMask(image);
+    else TraceLog(LOG_WARNING, "TEXCACHE: [%s] No hit mask, picked by its rectangle", entry->fileName);
+    UnloadImage(image);
+    entry->maskBaked = true;
+}
+
+bool CheckCollisionPointSprite(Sprite sprite, Rectangle source, Rectangle dest, Vector2 point)
+{
+    CachedTexture* entry = GetEntry(sprite.texture);
+    if ((entry == NULL) || (entry->fileName[0] == '\0') || !CheckCollisionPointRec(point, dest)) return false;
+
+    // Never made clickable, the rectangle is all there is to test
+    if (!entry->maskBaked) return true;
+
+    // Source art pixel under the point, the way SubmitSprite() maps source onto dest
+    float width = fabsf(source.width);
+    float u = (point.x - dest.x) / dest.width * width;
+    float x = source.x + ((source.width < 0) ? width - u : u);
+    float y = source.y + (point.y - dest.y) / dest.height * source.height;
+
+    if (sprite.trims != NULL)
+    {
+        int index = (int)(x / sprite.frameSize.x);
+        if ((index < 0) || (index >= sprite.frameCount)) return false;
+
+        // Only the trimmed part of the frame was packed, the rest is transparent
+        const SpriteTrim* trim = &sprite.trims[index];
+        x -= index * sprite.frameSize.x + trim->offset.x;
+        y -= trim->offset.y;
+        if ((x < 0) || (y < 0) || (x >= trim->region.width) || (y >= trim->region.height)) return false;
+
+        return IsHitMaskSet(&entry->mask, (int)(trim->region.x + x), (int)(trim->region.y + y));
+    }
+
+    return IsHitMaskSet(&entry->mask, (int)(sprite.region.x + x * sprite.scale), (int)(sprite.region.y + y * sprite.scale));
+}
+
+void RetainSprite(Sprite sprite)
+{
+    RetainTexture(sprite.texture);
+}
+
+void ReleaseSprite(Sprite sprite)
+{
+    ReleaseTexture(sprite.texture);
+}
+
+const char* ResolveImageFile(const char* fileName)
+{
+    if (FindAtlasFrame(fileName) != NULL) return atlasFile;
+
+    const char* variant = FindVariantFile(fileName);
+    return (variant != NULL) ? variant : fileName;
+}
+
+// File name for textures the cache loaded, size and format alone for the others (render
+// targets, the font atlas), those are told apart by where they are drawn
+unsigned int GetTextureIdentity(Texture2D texture)
+{
+    unsigned int hash = 2166136261u;
+
+    for (int i = 0; (texture.id != 0) && (i < MAX_CACHED_TEXTURES); ++i)
+    {
+        if (cache[i].texture.id == texture.id)
+        {
+            hash = HashPackPath(cache[i].fileName);
+            break;
+        }
+    }
+
+    int sizes[3] = { texture.width, texture.height, texture.format };
+    const unsigned char* bytes = (const unsigned char*)sizes;
+    for (int i = 0; i < (int)sizeof(sizes); ++i) hash = (hash ^ bytes[i]) * 16777619u;
+
+    return hash;
+}
+
+void SetTextureVariant(const char* directory)
+{
+    float scale = GetVariantScale(directory);
+    if ((scale <= 0.0f) || (scale >= 1.0f))
+    {
+        TraceLog(LOG_WARNING, "TEXCACHE: \"%s\" is not a downscaled variant, using full size textures", directory);
+        return;
+    }
+
+    strncpy(variantDirectory, directory, MAX_TEXTURE_PATH - 1);
+    variantScale = scale;
+
+    TraceLog(LOG_INFO, "TEXCACHE: Using \"%s\" texture variants (scale %.2f)", directory, scale);
+}
+
+float GetTextureScale(TextureHandle texture)
+{
+    CachedTexture* entry = GetEntry(texture);
+    return (entry != NULL && entry->scale > 0.0f) ? entry->scale : 1.0f;
+}
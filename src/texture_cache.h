@@ -0,0 +1,94 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#define MAX_CACHED_TEXTURES 64
+#define MAX_TEXTURE_PATH 128
+#define MAX_ATLAS_FRAMES 32
+#define MAX_ATLAS_TRIMS 128						// Trimmed frames over every sheet in the atlas
+#define TEXTURE_BUDGET_BYTES (128*1024*1024)	// Default, see SetTextureBudget()
+#define SOURCE_ART_SCALE 2						// Full HD art is twice the 960x540 layout, variant "2x"
+
+// Cache slot plus one, 0 is no texture. Stays valid while the texture is evicted, the next
+// UseTexture() loads it again
+typedef int TextureHandle;
+
+// Opaque part of one frame of a sheet, tools/atlas.c packs only that
+typedef struct SpriteTrim
+{
+	Rectangle region;		// In the atlas, empty for a fully transparent frame
+	Vector2 offset;			// Where it sits inside the untrimmed frame
+} SpriteTrim;
+
+// Texture plus the area of it the sprite sheet lives in, a sub-rectangle when atlased
+typedef struct Sprite
+{
+	TextureHandle texture;
+	Rectangle region;		// Untrimmed sheet size at the origin when trimmed
+	float scale;			// Texture pixels per source art pixel, below 1 for a downscaled variant
+	const SpriteTrim* trims;	// One per frame when trimmed, NULL otherwise
+	int frameCount;
+	Vector2 frameSize;		// Untrimmed frame, source art pixels
+} Sprite;
+
+typedef struct TextureCacheStats
+{
+	int hits;				// Acquires served by a resident texture since last report
+	int misses;				// Acquires that had to load from disk since last report
+	int unloaded;			// Textures unloaded since last report, evictions included
+	int reloads;			// Evicted textures drawn again since last report
+	int residentTextures;
+	int residentBytes;		// Width * height * bytes per pixel of every resident texture
+	int budgetBytes;
+	int savedBytes;			// Loading downscaled variants instead of full size, since last report
+	double loadSeconds;		// Read and decode on the main thread, misses the prefetch did not cover
+	double uploadSeconds;	// Image to GPU texture, always on the main thread
+} TextureCacheStats;
+
+// Variant directories are named after their scale of the layout, i.e. "1x" is half the art.
+// 0 when the name is not a scale, shared with tools/variants.c.
+static inline float GetVariantScale(const char* directory)
+{
+	int scale = 0;
+	for (; (*directory >= '0') && (*directory <= '9'); ++directory) scale = scale * 10 + (*directory - '0');
+	return ((scale > 0) && (directory[0] == 'x') && (directory[1] == '\0')) ? (float)scale / SOURCE_ART_SCALE : 0.0f;
+}
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+	//----------------------------------------------------------------------------------
+	// Texture Cache Functions Declaration
+	//----------------------------------------------------------------------------------
+	TextureHandle AcquireTexture(const char* fileName);	// Load texture or share the resident one, adds a reference
+	void RetainTexture(TextureHandle texture);		// Add a reference to an already acquired texture
+	void ReleaseTexture(TextureHandle texture);		// Drop a reference, texture stays resident until evicted
+	Texture2D UseTexture(TextureHandle texture);	// Texture to draw with, reloads it if evicted and marks it used
+	void UpdateTextureCache(void);					// Call once per frame before drawing, evicts down to the budget
+	void SetTextureBudget(int bytes);
+	void UnloadTextureCache(void);					// Unload every texture, used at exit
+	TextureCacheStats GetTextureCacheStats(void);
+	void TraceTextureCacheStats(const char* label);	// Log stats and reset hit/miss counters
+
+	bool LoadSpriteAtlas(const char* tableFile);	// Load frame table written by tools/atlas.c
+	Sprite AcquireSprite(const char* fileName);		// Atlas region when packed, whole texture otherwise
+	void BakeSpriteHitMask(Sprite sprite);			// Clickable sprites, at scene load, decodes the image once per texture
+	bool CheckCollisionPointSprite(Sprite sprite, Rectangle source, Rectangle dest, Vector2 point);	// Over a solid pixel of source drawn at dest
+	void RetainSprite(Sprite sprite);
+	void ReleaseSprite(Sprite sprite);
+	const char* ResolveImageFile(const char* fileName);	// Image actually loaded for a file, atlas or variant
+	unsigned int GetTextureIdentity(Texture2D texture);	// Same whatever order textures were uploaded in, unlike the GL id
+
+	void SetTextureVariant(const char* directory);	// Prefer "<dir>/<variant>/<file>" when it exists, see GetVariantScale()
+	float GetTextureScale(TextureHandle texture);	// Texture pixels per source pixel, 1 unless a variant
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEXTURE_CACHE_H
@@ -25,6 +25,9 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "render.h"
+#include "input.h"
+#include "draw_recorder.h"      // Draw calls are captured instead with DRAW_RECORDER defined
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -50,7 +53,7 @@ void UpdateTitleScreen(void)
     // TODO: Update TITLE screen variables here!
 
     // Press enter or tap to change to GAMEPLAY screen
-    if (IsKeyPressed(KEY_ENTER) || IsGestureDetected(GESTURE_TAP))
+    if (IsInputKeyPressed(KEY_ENTER) || IsInputTapped())
     {
         //finishScreen = 1;   // OPTIONS
         finishScreen = 2;   // GAMEPLAY
@@ -62,7 +65,7 @@ void DrawTitleScreen(void)
 {
     // TODO: Draw TITLE screen here!
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), GREEN);
-    DrawTextEx(font, "ko2fan presents", (Vector2) { 20, 10 }, font.baseSize * 3, 4, DARKGREEN);
+    DrawLabel("ko2fan presents", (Vector2) { 20, 10 }, font.baseSize * 3, 4, DARKGREEN);
 }
 
 // Title Screen Unload logic
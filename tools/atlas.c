@@ -0,0 +1,227 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Sprite atlas builder: packs sprite sheets into one texture so world sprites, NPCs and
+*   inventory icons all draw in a single raylib batch. Writes the atlas image and the frame
+*   table the game reads with LoadSpriteAtlas().
+*
+*   Every frame is cropped to its opaque pixels before packing, the game draws only that
+*   rectangle at its offset inside the frame. A sheet given as "file.png:N" is split into N
+*   frames across, otherwise it is cropped as a whole. The table holds one
+*   "sheet <file> frames frameWidth frameHeight" line per sheet, followed by one
+*   "trim x y width height offsetX offsetY" line per frame.
+*
+*   Build (from the repository root, links raylib, no window is opened):
+*       cc -O2 -Iinclude tools/atlas.c -lraylib -lm -o atlas
+*
+*   Usage:
+*       atlas data/atlas.png data/atlas.txt data/Chest.png:4 data/Key.png data/Woodcutter.png:4 \
+*             data/GraveRobber.png data/GraveRobber_walk2.png:6 data/butterfly1.png
+*
+*   NOTE: Key.png is left whole, the inventory draws the full strip as its icon
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_ATLAS_SHEETS 32
+#define MAX_ATLAS_SPRITES 128   // Frames over all sheets
+#define MAX_ATLAS_SIZE 4096
+#define ATLAS_PADDING 2         // Keeps neighbours out of reach of filtering and rounding
+
+typedef struct AtlasSheet
+{
+    char fileName[256];
+    int frames;
+    int frameWidth;
+    int frameHeight;
+} AtlasSheet;
+
+typedef struct AtlasSprite
+{
+    int sheet;
+    int frame;
+    Image image;            // Opaque part of the frame only
+    Vector2 offset;         // Of that part inside the frame
+    Rectangle region;
+} AtlasSprite;
+
+static AtlasSheet sheets[MAX_ATLAS_SHEETS];
+static int sheetCount = 0;
+static AtlasSprite sprites[MAX_ATLAS_SPRITES];
+static int spriteCount = 0;
+
+static int CompareHeight(const void* a, const void* b)
+{
+    return ((const AtlasSprite*)b)->image.height - ((const AtlasSprite*)a)->image.height;
+}
+
+static int CompareFrame(const void* a, const void* b)
+{
+    const AtlasSprite* first = (const AtlasSprite*)a;
+    const AtlasSprite* second = (const AtlasSprite*)b;
+
+    if (first->sheet != second->sheet) return first->sheet - second->sheet;
+    return first->frame - second->frame;
+}
+
+// Shelf packing: tallest first, left to right, next shelf when the row is full
+static bool PackShelves(int size)
+{
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+
+    for (int i = 0; i < spriteCount; ++i)
+    {
+        int width = sprites[i].image.width;
+        int height = sprites[i].image.height;
+
+        if (x + width > size)
+        {
+            x = 0;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        if (x + width > size || y + height > size) return false;
+
+        sprites[i].region = (Rectangle){ (float)x, (float)y, (float)width, (float)height };
+        x += width + ATLAS_PADDING;
+        if (height > shelfHeight) shelfHeight = height;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        fprintf(stderr, "usage: atlas <atlas.png> <atlas.txt> <sprite.png[:frames]>...\n");
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    long fullPixels = 0;
+    long trimmedPixels = 0;
+
+    for (int i = 3; i < argc && sheetCount < MAX_ATLAS_SHEETS; ++i)
+    {
+        AtlasSheet* sheet = &sheets[sheetCount];
+        snprintf(sheet->fileName, sizeof(sheet->fileName), "%s", argv[i]);
+        sheet->frames = 1;
+
+        char* count = strrchr(sheet->fileName, ':');
+        if (count != NULL)
+        {
+            *count = '\0';
+            sheet->frames = atoi(count + 1);
+            if (sheet->frames < 1) sheet->frames = 1;
+        }
+
+        Image image = LoadImage(sheet->fileName);
+        if (image.data == NULL)
+        {
+            fprintf(stderr, "atlas: cannot load %s\n", sheet->fileName);
+            return 1;
+        }
+
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        sheet->frameWidth = image.width / sheet->frames;
+        sheet->frameHeight = image.height;
+
+        if (spriteCount + sheet->frames > MAX_ATLAS_SPRITES)
+        {
+            fprintf(stderr, "atlas: more than %d frames\n", MAX_ATLAS_SPRITES);
+            return 1;
+        }
+
+        for (int f = 0; f < sheet->frames; ++f)
+        {
+            Rectangle cell = { (float)(f * sheet->frameWidth), 0, (float)sheet->frameWidth, (float)sheet->frameHeight };
+            Image frame = ImageFromImage(image, cell);
+            Rectangle opaque = GetImageAlphaBorder(frame, 0.0f);
+
+            // Fully transparent frames keep an empty rectangle and nothing is packed for them
+            if (opaque.width > 0 && opaque.height > 0) ImageCrop(&frame, opaque);
+            else
+            {
+                UnloadImage(frame);
+                frame = (Image){ 0 };
+                opaque = (Rectangle){ 0 };
+            }
+
+            sprites[spriteCount++] = (AtlasSprite){ sheetCount, f, frame, { opaque.x, opaque.y }, { 0, 0, 0, 0 } };
+
+            fullPixels += sheet->frameWidth * sheet->frameHeight;
+            trimmedPixels += (long)(opaque.width * opaque.height);
+        }
+
+        UnloadImage(image);
+        sheetCount += 1;
+    }
+
+    qsort(sprites, spriteCount, sizeof(AtlasSprite), CompareHeight);
+
+    int size = 256;
+    while (size <= MAX_ATLAS_SIZE && !PackShelves(size)) size *= 2;
+    if (size > MAX_ATLAS_SIZE)
+    {
+        fprintf(stderr, "atlas: sprites do not fit in %dx%d\n", MAX_ATLAS_SIZE, MAX_ATLAS_SIZE);
+        return 1;
+    }
+
+    Image atlas = GenImageColor(size, size, BLANK);
+    for (int i = 0; i < spriteCount; ++i)
+    {
+        if (sprites[i].image.data == NULL) continue;
+
+        Rectangle source = { 0, 0, (float)sprites[i].image.width, (float)sprites[i].image.height };
+        ImageDraw(&atlas, sprites[i].image, source, sprites[i].region, WHITE);
+    }
+
+    if (!ExportImage(atlas, argv[1]))
+    {
+        fprintf(stderr, "atlas: cannot write %s\n", argv[1]);
+        return 1;
+    }
+
+    FILE* table = fopen(argv[2], "w");
+    if (table == NULL)
+    {
+        fprintf(stderr, "atlas: cannot write %s\n", argv[2]);
+        return 1;
+    }
+
+    // Back to sheet order, the game reads each sheet's frames in order after its sheet line
+    qsort(sprites, spriteCount, sizeof(AtlasSprite), CompareFrame);
+
+    fprintf(table, "# Generated by tools/atlas.c, do not edit\n");
+    fprintf(table, "atlas %s\n", argv[1]);
+    for (int i = 0; i < spriteCount; ++i)
+    {
+        const AtlasSheet* sheet = &sheets[sprites[i].sheet];
+        if (sprites[i].frame == 0) fprintf(table, "sheet %s %d %d %d\n", sheet->fileName, sheet->frames, sheet->frameWidth, sheet->frameHeight);
+
+        Rectangle r = sprites[i].region;
+        fprintf(table, "trim %d %d %d %d %d %d\n", (int)r.x, (int)r.y, (int)r.width, (int)r.height,
+            (int)sprites[i].offset.x, (int)sprites[i].offset.y);
+        if (sprites[i].image.data != NULL) UnloadImage(sprites[i].image);
+    }
+    fclose(table);
+
+    printf("atlas: %d sheets, %d frames -> %s (%dx%d)\n", sheetCount, spriteCount, argv[1], size, size);
+    printf("atlas: trimming kept %ld of %ld frame pixels (%.1f%%), %ld pixels saved\n", trimmedPixels, fullPixels,
+        (fullPixels > 0) ? 100.0 * trimmedPixels / fullPixels : 0.0, fullPixels - trimmedPixels);
+
+    UnloadImage(atlas);
+    return 0;
+}
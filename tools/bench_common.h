@@ -0,0 +1,49 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Bench common: what every benchmark in tools/ needs, a random source that gives the same
+*   rooms and mouse paths on every platform, a wall clock and, for benches that link the game
+*   files, the globals main.c defines. Each bench is a single file, so this is header only.
+*
+*   Define BENCH_GAME_GLOBALS before including it in a bench that links src/game.c.
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <time.h>
+
+#if defined(BENCH_GAME_GLOBALS)
+#include "raylib.h"
+#include "screens.h"
+
+// Globals main.c defines for the game
+GameScreen currentScreen = GAMEPLAY;
+Font font = { 0 };
+Music music = { 0 };
+float updateStep = 1.0f / 60.0f;
+float drawAlpha = 0.0f;
+#endif
+
+static unsigned int seed = 12345u;
+
+// Same on every platform, unlike rand()
+static inline float Random(float range)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (float)(seed >> 8) / 16777216.0f * range;
+}
+
+// Seconds, for benches that do not open a window and so cannot use GetTime()
+static inline double Now(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + now.tv_nsec / 1e9;
+}
+
+#endif // BENCH_COMMON_H
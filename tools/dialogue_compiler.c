@@ -0,0 +1,379 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Dialogue compiler: turns a dialogue tree written as text into the binary graph the game
+*   walks, see src/dialogue.h for the layout. Node names become indices and every string is
+*   stored once, so nothing is parsed or looked up by name at runtime.
+*
+*   Source, one statement per line, '#' starts a comment line:
+*       node <name>                     Starts a node, the first one is where talking starts
+*       say <text>                      What the NPC says in this node
+*       set <flag>... / clear <flag>... Flags changed once the node shows, answers see them
+*       goto <node>                     Jump on entering instead, the first one that applies
+*       answer <text> -> <node>         One line the player can pick, "end" as node ends the talk
+*       if <flag>... goto/answer ...    Only when every flag is set, "!flag" when it is clear
+*
+*   Answers are not measured here, the game lays them out with whichever font it ended up
+*   loading, the SDF one or the bitmap fallback.
+*
+*   Build (from the repository root, raylib headers only for the shared types):
+*       cc -O2 -Iinclude -Isrc tools/dialogue_compiler.c -o dialogue_compiler
+*
+*   Usage:
+*       dialogue_compiler tools/dialogue/woodcutter.txt data/woodcutter.dlg
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "dialogue.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SOURCE_LINE 1024
+
+static const char* sourceName = NULL;
+static int lineNumber = 0;
+
+// Grown as the source is read
+static DialogueNode* nodes = NULL;
+static int* nodeLines = NULL;               // Source line of each, for errors found after reading
+static int nodeCount = 0;
+static DialogueBranch* branches = NULL;
+static unsigned int* branchNames = NULL;    // Target names until they are resolved to nodes
+static int* branchLines = NULL;
+static int branchCount = 0;
+static DialogueAnswer* answers = NULL;
+static unsigned int* answerNames = NULL;
+static int* answerLines = NULL;
+static int answerCount = 0;
+static unsigned int flagNames[MAX_DIALOGUE_FLAGS];
+static int flagCount = 0;
+
+// Interned strings, hashed by content
+static char* strings = NULL;
+static unsigned int stringsSize = 0;
+static unsigned int stringsCapacity = 0;
+static unsigned int* internSlots = NULL;    // Offset + 1, 0 is empty
+static unsigned int internSlotCount = 0;
+static int internedCount = 0;
+static int internRequests = 0;
+
+static unsigned int* slots = NULL;
+static unsigned int slotCount = 0;
+
+static void Fail(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    if (lineNumber > 0) fprintf(stderr, "%s:%i: ", sourceName, lineNumber);
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+
+    exit(1);
+}
+
+static void* Grow(void* array, int count, size_t size)
+{
+    // Room for 16 first, doubled whenever count reaches a power of two past that
+    if ((count != 0) && ((count < 16) || ((count & (count - 1)) != 0))) return array;
+
+    array = realloc(array, ((count != 0) ? count * 2 : 16) * size);
+    if (array == NULL) Fail("Out of memory");
+    return array;
+}
+
+static void AddToInternSlots(unsigned int offset)
+{
+    unsigned int mask = internSlotCount - 1;
+    unsigned int slot = HashPackPath(strings + offset) & mask;
+    while (internSlots[slot] != 0) slot = (slot + 1) & mask;
+    internSlots[slot] = offset + 1;
+}
+
+static unsigned int Intern(const char* text)
+{
+    internRequests += 1;
+
+    // Kept at most half full
+    if ((unsigned int)(internedCount + 1) * 2 > internSlotCount)
+    {
+        free(internSlots);
+        internSlotCount = internSlotCount ? internSlotCount * 2 : 1024;
+        internSlots = (unsigned int*)calloc(internSlotCount, sizeof(unsigned int));
+        if (internSlots == NULL) Fail("Out of memory");
+
+        for (unsigned int offset = 0; offset < stringsSize; offset += (unsigned int)strlen(strings + offset) + 1) AddToInternSlots(offset);
+    }
+
+    unsigned int mask = internSlotCount - 1;
+    for (unsigned int slot = HashPackPath(text) & mask; internSlots[slot] != 0; slot = (slot + 1) & mask)
+    {
+        if (strcmp(strings + internSlots[slot] - 1, text) == 0) return internSlots[slot] - 1;
+    }
+
+    unsigned int length = (unsigned int)strlen(text) + 1;
+    while (stringsSize + length > stringsCapacity)
+    {
+        stringsCapacity = stringsCapacity ? stringsCapacity * 2 : 4096;
+        strings = (char*)realloc(strings, stringsCapacity);
+        if (strings == NULL) Fail("Out of memory");
+    }
+
+    unsigned int offset = stringsSize;
+    memcpy(strings + offset, text, length);
+    stringsSize += length;
+    internedCount += 1;
+    AddToInternSlots(offset);
+
+    return offset;
+}
+
+static unsigned int FlagBit(const char* name)
+{
+    unsigned int offset = Intern(name);
+    for (int i = 0; i < flagCount; ++i)
+    {
+        if (flagNames[i] == offset) return 1u << i;
+    }
+
+    if (flagCount == MAX_DIALOGUE_FLAGS) Fail("More than %i flags", MAX_DIALOGUE_FLAGS);
+
+    flagNames[flagCount] = offset;
+    flagCount += 1;
+    return 1u << (flagCount - 1);
+}
+
+static char* Trim(char* text)
+{
+    while (*text == ' ' || *text == '\t') text += 1;
+
+    char* end = text + strlen(text);
+    while (end > text && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n')) end -= 1;
+    *end = '\0';
+
+    return text;
+}
+
+// Splits off the first word of text, returns it and moves text past it
+static char* NextWord(char** text)
+{
+    char* word = *text;
+    char* end = word;
+    while (*end != '\0' && *end != ' ' && *end != '\t') end += 1;
+
+    *text = Trim(end + ((*end != '\0') ? 1 : 0));
+    *end = '\0';
+    return word;
+}
+
+static void AddBranch(unsigned int required, unsigned int excluded, char* rest)
+{
+    char* target = NextWord(&rest);
+    if (*target == '\0' || *rest != '\0') Fail("Expected goto <node>");
+
+    branches = (DialogueBranch*)Grow(branches, branchCount, sizeof(DialogueBranch));
+    branchNames = (unsigned int*)Grow(branchNames, branchCount, sizeof(unsigned int));
+    branchLines = (int*)Grow(branchLines, branchCount, sizeof(int));
+    branches[branchCount] = (DialogueBranch){ required, excluded, 0 };
+    branchNames[branchCount] = Intern(target);
+    branchLines[branchCount] = lineNumber;
+    branchCount += 1;
+    nodes[nodeCount - 1].branchCount += 1;
+}
+
+static void AddAnswer(unsigned int required, unsigned int excluded, char* rest)
+{
+    char* arrow = NULL;
+    for (char* found = strstr(rest, "->"); found != NULL; found = strstr(found + 2, "->")) arrow = found;
+    if (arrow == NULL) Fail("Expected answer <text> -> <node>");
+
+    *arrow = '\0';
+    char* text = Trim(rest);
+    char* target = Trim(arrow + 2);
+    if (*text == '\0' || *target == '\0' || strchr(target, ' ') != NULL) Fail("Expected answer <text> -> <node>");
+
+    answers = (DialogueAnswer*)Grow(answers, answerCount, sizeof(DialogueAnswer));
+    answerNames = (unsigned int*)Grow(answerNames, answerCount, sizeof(unsigned int));
+    answerLines = (int*)Grow(answerLines, answerCount, sizeof(int));
+    answers[answerCount] = (DialogueAnswer){ .required = required, .excluded = excluded, .text = Intern(text) };
+    answerNames[answerCount] = Intern(target);
+    answerLines[answerCount] = lineNumber;
+    answerCount += 1;
+    nodes[nodeCount - 1].answerCount += 1;
+}
+
+static void ParseLine(char* line)
+{
+    line = Trim(line);
+    if (*line == '\0' || *line == '#') return;
+
+    char* rest = line;
+    char* keyword = NextWord(&rest);
+
+    if (strcmp(keyword, "node") == 0)
+    {
+        if (*rest == '\0' || strchr(rest, ' ') != NULL || strcmp(rest, "end") == 0) Fail("Expected node <name>, \"end\" is taken");
+
+        nodes = (DialogueNode*)Grow(nodes, nodeCount, sizeof(DialogueNode));
+        nodeLines = (int*)Grow(nodeLines, nodeCount, sizeof(int));
+        nodeLines[nodeCount] = lineNumber;
+        nodes[nodeCount] = (DialogueNode){ .hash = HashPackPath(rest), .name = Intern(rest), .text = 0,
+            .firstBranch = branchCount, .firstAnswer = answerCount };
+        nodeCount += 1;
+        return;
+    }
+
+    if (nodeCount == 0) Fail("Statement before the first node");
+    DialogueNode* node = &nodes[nodeCount - 1];
+
+    if (strcmp(keyword, "say") == 0)
+    {
+        if (node->text != 0) Fail("Node already says something");
+        node->text = Intern(rest);
+    }
+    else if (strcmp(keyword, "set") == 0 || strcmp(keyword, "clear") == 0)
+    {
+        unsigned int* flags = (keyword[0] == 's') ? &node->setFlags : &node->clearFlags;
+        if (*rest == '\0') Fail("Expected %s <flag>...", keyword);
+        while (*rest != '\0') *flags |= FlagBit(NextWord(&rest));
+    }
+    else if (strcmp(keyword, "goto") == 0) AddBranch(0, 0, rest);
+    else if (strcmp(keyword, "answer") == 0) AddAnswer(0, 0, rest);
+    else if (strcmp(keyword, "if") == 0)
+    {
+        unsigned int required = 0;
+        unsigned int excluded = 0;
+
+        for (;;)
+        {
+            char* word = NextWord(&rest);
+            if (*word == '\0') Fail("Expected goto or answer after the condition");
+
+            if (strcmp(word, "goto") == 0) AddBranch(required, excluded, rest);
+            else if (strcmp(word, "answer") == 0) AddAnswer(required, excluded, rest);
+            else if (word[0] == '!') excluded |= FlagBit(word + 1);
+            else required |= FlagBit(word);
+
+            if (strcmp(word, "goto") == 0 || strcmp(word, "answer") == 0) break;
+        }
+
+        if (required & excluded) Fail("A flag both set and clear never applies");
+    }
+    else Fail("Unknown statement \"%s\"", keyword);
+}
+
+// Same FNV-1a directory as the asset pack, twice the nodes rounded up to a power of two
+static void BuildDirectory(void)
+{
+    slotCount = 1;
+    while (slotCount < (unsigned int)nodeCount * 2) slotCount *= 2;
+    slots = (unsigned int*)calloc(slotCount, sizeof(unsigned int));
+    if (slots == NULL) Fail("Out of memory");
+
+    unsigned int mask = slotCount - 1;
+    for (int i = 0; i < nodeCount; ++i)
+    {
+        unsigned int slot = nodes[i].hash & mask;
+        for (; slots[slot] != 0; slot = (slot + 1) & mask)
+        {
+            if (nodes[slots[slot] - 1].name != nodes[i].name) continue;
+
+            lineNumber = nodeLines[i];
+            Fail("Node \"%s\" defined twice, first on line %i", strings + nodes[i].name, nodeLines[slots[slot] - 1]);
+        }
+
+        slots[slot] = i + 1;
+    }
+}
+
+static unsigned int ResolveTarget(unsigned int name, int line)
+{
+    lineNumber = line;
+    if (strcmp(strings + name, "end") == 0) return DIALOGUE_END;
+
+    unsigned int mask = slotCount - 1;
+    for (unsigned int slot = HashPackPath(strings + name) & mask; slots[slot] != 0; slot = (slot + 1) & mask)
+    {
+        if (nodes[slots[slot] - 1].name == name) return slots[slot] - 1;
+    }
+
+    Fail("Unknown node \"%s\"", strings + name);
+    return DIALOGUE_END;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <source.txt> <output.dlg>\n", argv[0]);
+        return 1;
+    }
+
+    FILE* source = fopen(argv[1], "r");
+    if (source == NULL) Fail("Cannot read %s", argv[1]);
+    sourceName = argv[1];
+
+    Intern("");         // Offset 0, the text of nodes that say nothing
+    char line[MAX_SOURCE_LINE];
+    while (fgets(line, sizeof(line), source) != NULL)
+    {
+        lineNumber += 1;
+        if (strchr(line, '\n') == NULL && !feof(source)) Fail("Line longer than %i characters", MAX_SOURCE_LINE - 1);
+        ParseLine(line);
+    }
+
+    fclose(source);
+    lineNumber = 0;
+    if (nodeCount == 0) Fail("%s has no nodes", argv[1]);
+
+    BuildDirectory();
+    for (int i = 0; i < branchCount; ++i) branches[i].target = ResolveTarget(branchNames[i], branchLines[i]);
+    for (int i = 0; i < answerCount; ++i) answers[i].target = ResolveTarget(answerNames[i], answerLines[i]);
+    lineNumber = 0;
+
+    for (int i = 0; i < nodeCount; ++i)
+    {
+        if (nodes[i].answerCount > MAX_DIALOGUE_ANSWERS)
+        {
+            printf("warning: node \"%s\" has %u answers, only the first %i that apply show\n", strings + nodes[i].name,
+                nodes[i].answerCount, MAX_DIALOGUE_ANSWERS);
+        }
+    }
+
+    DialogueHeader header = { 0 };
+    memcpy(header.magic, DIALOGUE_MAGIC, 4);
+    header.version = DIALOGUE_VERSION;
+    header.nodeCount = nodeCount;
+    header.branchCount = branchCount;
+    header.answerCount = answerCount;
+    header.slotCount = slotCount;
+    header.flagCount = flagCount;
+    header.stringsSize = stringsSize;
+
+    FILE* output = fopen(argv[2], "wb");
+    if (output == NULL) Fail("Cannot write %s", argv[2]);
+
+    fwrite(&header, sizeof(header), 1, output);
+    fwrite(nodes, sizeof(DialogueNode), nodeCount, output);
+    fwrite(branches, sizeof(DialogueBranch), branchCount, output);
+    fwrite(answers, sizeof(DialogueAnswer), answerCount, output);
+    fwrite(slots, sizeof(unsigned int), slotCount, output);
+    fwrite(flagNames, sizeof(unsigned int), flagCount, output);
+    fwrite(strings, 1, stringsSize, output);
+    long total = ftell(output);
+
+    if (fclose(output) != 0) Fail("Cannot write %s", argv[2]);
+
+    printf("%s: %i nodes, %i branches, %i answers, %i flags\n", argv[2], nodeCount, branchCount, answerCount, flagCount);
+    printf("  %i strings in %u bytes, %i repeats interned away, %li bytes in all\n", internedCount, stringsSize,
+        internRequests - internedCount, total);
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Frame recorder benchmark: runs the gameplay screen with the draw recorder, times building
+*   each forest frame without drawing it, hashes the frames and replays the last one through
+*   raylib. No input is given, so the update timing is a whole idle scene update with the
+*   mouse at rest. Given the hash of a known good first frame it exits with 1 when it no longer
+*   matches, so a renderer change that moves a single quad fails the check.
+*
+*   Build (from the repository root, links raylib, every game file with DRAW_RECORDER):
+*       cc -O2 -DDRAW_RECORDER -Iinclude -Isrc tools/frame_bench.c src/draw_recorder.c src/game.c \
+*          src/forest_scene.c src/ruins_scene.c src/scene_objects.c src/hotspots.c src/navigation.c src/input.c \
+*          src/render.c src/background.c src/texture_cache.c src/hit_mask.c src/asset_prefetch.c src/asset_pack.c \
+*          src/text.c src/text_cache.c src/dialogue.c \
+*          -lraylib -lpthread -lm -o frame_bench
+*
+*   Usage (no GPU needed with Mesa's software driver):
+*       LIBGL_ALWAYS_SOFTWARE=1 frame_bench [frames] [expected first frame hash]
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "screens.h"
+#include "render.h"
+#include "text.h"
+#include "text_cache.h"
+#include "texture_cache.h"
+#include "input.h"
+#include "draw_recorder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_GAME_GLOBALS
+#include "bench_common.h"
+
+static DrawFrame firstFrame = { 0 };
+
+int main(int argc, char* argv[])
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : 600;
+    unsigned int expected = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 16) : 0;
+    if (frames < 1) frames = 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(860, 540, "frame_bench");
+    SetTargetFPS(0);
+
+    font = LoadGameFont("data/pixantiqua.ttf");
+    LoadTextCache();
+    SetRenderView(860, 540, 1);
+    InitGameplayScreen();
+
+    double updateSeconds = 0.0;
+    double recordSeconds = 0.0;
+    int changedFrames = 0;
+    unsigned int previous = 0;
+
+    for (int i = 0; i < frames; ++i)
+    {
+        // Same order as UpdateDrawFrame() in main.c, without the input
+        UpdateTextureCache();
+        if (UpdateGameFont()) font = GetGameFont();
+        UpdateTextCache();
+        UpdateInput();
+        double start = GetTime();
+        UpdateGameplayScreen();
+        updateSeconds += GetTime() - start;
+        ConsumeInput();
+
+        start = GetTime();
+        ResetDrawStats();
+        BeginRecordedFrame();
+        ClearBackground(RAYWHITE);
+        DrawGameplayScreen();
+        FlushRenderQueue();
+        EndRecordedFrame();
+        recordSeconds += GetTime() - start;
+
+        const DrawFrame* recorded = GetRecordedFrame();
+        unsigned int hash = HashDrawFrame(recorded);
+        if ((i > 0) && (hash != previous)) changedFrames += 1;
+        previous = hash;
+
+        if (i == 0) firstFrame = *recorded;
+    }
+
+    const DrawFrame* lastFrame = GetRecordedFrame();
+    unsigned int firstHash = HashDrawFrame(&firstFrame);
+
+    // Replaying draws for real, the first frames pay for uploads and are not timed
+    double replaySeconds = 0.0;
+    for (int i = -10; i < frames; ++i)
+    {
+        double start = GetTime();
+        BeginDrawing();
+        ReplayDrawFrame(lastFrame);
+        EndDrawing();
+        if (i >= 0) replaySeconds += GetTime() - start;
+    }
+
+    printf("forest, %d frames\n", frames);
+    printf("  update: %8.3f ms/frame, mouse at rest\n", updateSeconds * 1000.0 / frames);
+    printf("  record: %8.3f ms/frame, %d commands in the last frame\n", recordSeconds * 1000.0 / frames, lastFrame->count);
+    printf("  replay: %8.3f ms/frame\n", replaySeconds * 1000.0 / frames);
+    printf("  first frame hash %08x, %d frames differ from the one before\n", firstHash, changedFrames);
+
+    int diff = DiffDrawFrames(&firstFrame, lastFrame);
+    if (diff >= 0) printf("  last frame differs from the first from command %d on\n", diff);
+
+    UnloadGameplayScreen();
+    UnloadTextureCache();
+    UnloadRenderView();
+    UnloadTextCache();
+    UnloadGameFont();
+    CloseWindow();
+
+    if ((argc > 2) && (firstHash != expected))
+    {
+        printf("  expected %08x, frame changed\n", expected);
+        return 1;
+    }
+
+    return 0;
+}
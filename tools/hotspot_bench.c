@@ -0,0 +1,95 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Hotspot benchmark: scatters hotspots over a large room, picks random points with the
+*   linear scan the scenes used to run and with the hotspot grid, checks both agree on the
+*   topmost hit and prints the time per query. The points and rectangles come from a fixed
+*   seed, so runs compare.
+*
+*   Build (from the repository root, links raylib for the rectangle test and allocator only):
+*       cc -O2 -Iinclude -Isrc tools/hotspot_bench.c src/hotspots.c -lraylib -lm -o hotspot_bench
+*
+*   Usage:
+*       hotspot_bench [hotspots] [queries]
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "hotspots.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+
+#define ROOM_WIDTH 16384.0f
+#define ROOM_HEIGHT 4096.0f
+
+// What UpdateForestScene() did per frame before the grid, last match is drawn on top
+static int FindLinear(const Rectangle* bounds, int count, Vector2 point)
+{
+    for (int i = count - 1; i >= 0; --i)
+    {
+        if (CheckCollisionPointRec(point, bounds[i])) return i;
+    }
+
+    return -1;
+}
+
+int main(int argc, char* argv[])
+{
+    int count = (argc > 1) ? atoi(argv[1]) : 10000;
+    int queries = (argc > 2) ? atoi(argv[2]) : 1000000;
+    if (count < 1) count = 1;
+    if (queries < 1) queries = 1;
+
+    Rectangle* bounds = (Rectangle*)malloc(count * sizeof(Rectangle));
+    Vector2* points = (Vector2*)malloc(queries * sizeof(Vector2));
+
+    // Clickables at the game's 4x scale, from a key to an actor
+    for (int i = 0; i < count; ++i)
+    {
+        float size = 32.0f + Random(160.0f);
+        bounds[i] = (Rectangle){ Random(ROOM_WIDTH - size), Random(ROOM_HEIGHT - size), size, size };
+    }
+
+    for (int i = 0; i < queries; ++i) points[i] = (Vector2){ Random(ROOM_WIDTH), Random(ROOM_HEIGHT) };
+
+    HotspotGrid grid = { 0 };
+    double start = Now();
+    BuildHotspotGrid(&grid, bounds, count, HOTSPOT_CELL_SIZE);
+    double buildMs = (Now() - start) * 1000.0;
+
+    // Linear is slow, a slice of the queries is enough to time it
+    int linearQueries = (queries < 100000) ? queries : 100000;
+    int hits = 0;
+    int mismatches = 0;
+
+    start = Now();
+    for (int i = 0; i < linearQueries; ++i) hits += (FindLinear(bounds, count, points[i]) != -1);
+    double linearNs = (Now() - start) * 1e9 / linearQueries;
+
+    start = Now();
+    for (int i = 0; i < queries; ++i) hits += (FindHotspot(&grid, points[i]) != -1);
+    double gridNs = (Now() - start) * 1e9 / queries;
+
+    for (int i = 0; i < linearQueries; ++i)
+    {
+        if (FindLinear(bounds, count, points[i]) != FindHotspot(&grid, points[i])) mismatches += 1;
+    }
+
+    printf("%d hotspots in a %.0fx%.0f room, %d queries\n", count, ROOM_WIDTH, ROOM_HEIGHT, queries);
+    printf("  grid build:  %8.3f ms, %dx%d cells of %.0f\n", buildMs, grid.columns, grid.rows, grid.cellSize);
+    printf("  linear scan: %8.1f ns/query\n", linearNs);
+    printf("  grid:        %8.1f ns/query  (%.1fx faster, %d hits)\n", gridNs, (gridNs > 0.0) ? linearNs / gridNs : 0.0, hits);
+    printf("  %d of %d queries disagree\n", mismatches, linearQueries);
+
+    UnloadHotspotGrid(&grid);
+    free(points);
+    free(bounds);
+
+    return (mismatches == 0) ? 0 : 1;
+}
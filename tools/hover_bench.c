@@ -0,0 +1,123 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Hover benchmark: fills a large room with chests, a few of them opening, and runs the
+*   highlight pick of one scene update many times over. Once with the mouse still, the idle
+*   scene case, and once with it moving every update. Each case is timed picking afresh the
+*   way scenes did before PickSceneObject() and through it, and both must agree on every
+*   update. Rooms and mouse paths come from a fixed seed, so runs compare. Only the pick is
+*   timed, tools/frame_bench.c times a whole idle forest update.
+*
+*   Build (from the repository root, links raylib and the game files SceneObjects needs):
+*       cc -O2 -Iinclude -Isrc tools/hover_bench.c src/scene_objects.c src/game.c src/forest_scene.c \
+*          src/ruins_scene.c src/hotspots.c src/navigation.c src/input.c src/render.c src/background.c \
+*          src/texture_cache.c src/hit_mask.c src/asset_prefetch.c src/asset_pack.c src/text.c src/text_cache.c \
+*          src/dialogue.c -lraylib -lpthread -lm -o hover_bench
+*
+*   Usage (reads data/Chest.png):
+*       hover_bench [objects] [updates]
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "screens.h"
+#include "scenes.h"
+#include "hotspots.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_GAME_GLOBALS
+#include "bench_common.h"
+
+#define ROOM_WIDTH 16384.0f
+#define ROOM_HEIGHT 4096.0f
+
+// What UpdateForestScene() ran every update before the pick was kept
+static int PickAfresh(const SceneObjects* objects, const HotspotGrid* grid, Vector2 point)
+{
+    int hit = FindHotspot(grid, point);
+    while ((hit != -1) && !IsPointOnSceneObject(objects, hit, point)) hit = FindHotspotBelow(grid, point, hit);
+
+    return hit;
+}
+
+// Times updates of one case, picking afresh when cached is false, returns microseconds per update
+static double RunUpdates(SceneObjects* objects, const HotspotGrid* grid, const Vector2* points, int updates, bool cached, int* mismatches)
+{
+    double total = 0.0;
+
+    for (int i = 0; i < updates; ++i)
+    {
+        AnimateSceneObjects(objects);
+
+        double start = GetTime();
+        int hit = cached ? PickSceneObject(objects, grid, points[i]) : PickAfresh(objects, grid, points[i]);
+        total += GetTime() - start;
+
+        if (cached && (hit != PickAfresh(objects, grid, points[i]))) *mismatches += 1;
+    }
+
+    return total * 1e6 / updates;
+}
+
+int main(int argc, char* argv[])
+{
+    int count = (argc > 1) ? atoi(argv[1]) : 10000;
+    int updates = (argc > 2) ? atoi(argv[2]) : 100000;
+    if (count < 1) count = 1;
+    if (updates < 1) updates = 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(860, 540, "hover_bench");
+
+    // Every second one open, they animate through the first updates like in a scene
+    SceneObjects objects = { 0 };
+    LoadSceneObjects(&objects, count);
+    for (int i = 0; i < count; ++i)
+    {
+        Vector2 position = { Random(ROOM_WIDTH - 128.0f), Random(ROOM_HEIGHT - 128.0f) };
+        unsigned char flags = OBJECT_CAN_OPEN | (((i % 2) == 0) ? OBJECT_OPEN : 0);
+        AddSceneObject(&objects, (Animation){ .sprite = AcquireSprite("data/Chest.png"), .total_frames = 4 },
+            position, (Vector2){ 32, 32 }, (Vector2){ 4, 4 }, flags, "Treasure Chest");
+    }
+
+    Rectangle* bounds = (Rectangle*)MemAlloc(count * sizeof(Rectangle));
+    GetSceneObjectHotspots(&objects, bounds);
+    HotspotGrid grid = { 0 };
+    BuildHotspotGrid(&grid, bounds, count, HOTSPOT_CELL_SIZE);
+
+    // Mouse resting on the middle of a chest, then wandering the room
+    Vector2* still = (Vector2*)MemAlloc(updates * sizeof(Vector2));
+    Vector2* moving = (Vector2*)MemAlloc(updates * sizeof(Vector2));
+    Vector2 rest = { bounds[count / 2].x + bounds[count / 2].width / 2, bounds[count / 2].y + bounds[count / 2].height / 2 };
+    for (int i = 0; i < updates; ++i)
+    {
+        still[i] = rest;
+        moving[i] = (Vector2){ Random(ROOM_WIDTH), Random(ROOM_HEIGHT) };
+    }
+
+    int mismatches = 0;
+    double idleAfresh = RunUpdates(&objects, &grid, still, updates, false, &mismatches);
+    double idleKept = RunUpdates(&objects, &grid, still, updates, true, &mismatches);
+    double movingAfresh = RunUpdates(&objects, &grid, moving, updates, false, &mismatches);
+    double movingKept = RunUpdates(&objects, &grid, moving, updates, true, &mismatches);
+
+    printf("%d objects, %d updates per case\n", count, updates);
+    printf("  mouse still:  %8.3f us/update picking afresh, %8.3f us/update kept\n", idleAfresh, idleKept);
+    printf("  mouse moving: %8.3f us/update picking afresh, %8.3f us/update kept\n", movingAfresh, movingKept);
+    printf("  %d mismatches\n", mismatches);
+
+    MemFree(moving);
+    MemFree(still);
+    UnloadHotspotGrid(&grid);
+    MemFree(bounds);
+    UnloadSceneObjects(&objects);
+    CloseWindow();
+
+    return (mismatches == 0) ? 0 : 1;
+}
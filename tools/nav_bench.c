@@ -0,0 +1,99 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Navigation benchmark: builds a navmesh for a large room with an uneven floor and a few
+*   hundred blockers, then times random clicks, first as A* searches and then again from the
+*   path cache. Every corner of every path is checked to be on the floor. Rooms, blockers and
+*   clicks come from a fixed seed, so runs compare.
+*
+*   Build (from the repository root, links raylib for the allocator only):
+*       cc -O2 -Iinclude -Isrc tools/nav_bench.c src/navigation.c -lraylib -lm -o nav_bench
+*
+*   Usage:
+*       nav_bench [blockers] [clicks]
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "navigation.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+
+#define ROOM_WIDTH 8192.0f
+#define ROOM_HEIGHT 2048.0f
+
+int main(int argc, char* argv[])
+{
+    int blockerCount = (argc > 1) ? atoi(argv[1]) : 300;
+    int clicks = (argc > 2) ? atoi(argv[2]) : 100;
+    if (blockerCount < 0) blockerCount = 0;
+    if (clicks < 1) clicks = 1;
+
+    // Floor narrows towards the back of the room like a perspective floor would
+    Vector2 floor[] = {
+        { 1024, 0 }, { ROOM_WIDTH - 1024, 0 }, { ROOM_WIDTH, ROOM_HEIGHT / 2 },
+        { ROOM_WIDTH, ROOM_HEIGHT }, { 0, ROOM_HEIGHT }, { 0, ROOM_HEIGHT / 2 }
+    };
+
+    Rectangle* blockers = (Rectangle*)malloc((blockerCount > 0 ? blockerCount : 1) * sizeof(Rectangle));
+    for (int i = 0; i < blockerCount; ++i)
+    {
+        float width = 64.0f + Random(192.0f);
+        float height = 32.0f + Random(96.0f);
+        blockers[i] = (Rectangle){ Random(ROOM_WIDTH - width), Random(ROOM_HEIGHT - height), width, height };
+    }
+
+    Vector2* starts = (Vector2*)malloc(clicks * sizeof(Vector2));
+    Vector2* goals = (Vector2*)malloc(clicks * sizeof(Vector2));
+    for (int i = 0; i < clicks; ++i)
+    {
+        starts[i] = (Vector2){ Random(ROOM_WIDTH), ROOM_HEIGHT / 2 + Random(ROOM_HEIGHT / 2) };
+        goals[i] = (Vector2){ Random(ROOM_WIDTH), Random(ROOM_HEIGHT) };
+    }
+
+    NavMesh mesh = { 0 };
+    double start = Now();
+    LoadNavMesh(&mesh, floor, sizeof(floor) / sizeof(floor[0]), blockers, blockerCount, NAV_CELL_SIZE);
+    double loadMs = (Now() - start) * 1000.0;
+
+    NavPath path = { 0 };
+    int found = 0;
+    int corners = 0;
+    int offFloor = 0;
+
+    start = Now();
+    for (int i = 0; i < clicks; ++i)
+    {
+        if (!FindNavPath(&mesh, starts[i], goals[i], &path)) continue;
+
+        found += 1;
+        corners += path.count;
+        for (int c = 0; c < path.count; ++c) offFloor += !IsOnNavMesh(&mesh, path.points[c]);
+    }
+    double searchUs = (Now() - start) * 1e6 / clicks;
+    int searches = mesh.searches;
+
+    start = Now();
+    for (int i = 0; i < clicks; ++i) FindNavPath(&mesh, starts[i], goals[i], &path);
+    double cachedUs = (Now() - start) * 1e6 / clicks;
+
+    printf("%.0fx%.0f room, %d blockers, %d clicks\n", ROOM_WIDTH, ROOM_HEIGHT, blockerCount, clicks);
+    printf("  navmesh load: %8.3f ms, %dx%d cells of %.0f\n", loadMs, mesh.columns, mesh.rows, mesh.cellSize);
+    printf("  first clicks: %8.2f us/click  (%d searches, %d paths, %.1f corners each)\n", searchUs, searches, found,
+        (found > 0) ? (float)corners / found : 0.0f);
+    printf("  same clicks:  %8.2f us/click  (%d cache hits)\n", cachedUs, mesh.cacheHits);
+    printf("  %d corners off the floor\n", offFloor);
+
+    UnloadNavMesh(&mesh);
+    free(goals);
+    free(starts);
+    free(blockers);
+
+    return (offFloor == 0) ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Scene objects benchmark: lays out a large grid of clickables and runs what a scene does
+*   with them each frame, animate, gather hotspot bounds and cull plus submit for drawing.
+*   It runs once over the old one-struct-per-object array and once over SceneObjects and
+*   prints the time of each pass. Nothing is flushed, so no GPU work is timed.
+*
+*   Build (from the repository root, links raylib and the game files SceneObjects needs):
+*       cc -O2 -Iinclude -Isrc tools/objects_bench.c src/scene_objects.c src/game.c src/forest_scene.c \
+*          src/ruins_scene.c src/hotspots.c src/navigation.c src/input.c src/render.c src/background.c \
+*          src/texture_cache.c src/hit_mask.c src/asset_prefetch.c src/asset_pack.c src/text.c src/text_cache.c \
+*          src/dialogue.c -lraylib -lpthread -lm -o objects_bench
+*
+*   Usage:
+*       objects_bench [objects] [frames]
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "screens.h"
+#include "scenes.h"
+#include "render.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_GAME_GLOBALS
+#include "bench_common.h"
+
+#define OBJECTS_PER_ROW 1000
+#define OBJECT_SPACING 200.0f
+
+// What scenes kept per clickable before SceneObjects
+typedef struct LegacyObject
+{
+    WorldObject world_item;
+    InventoryObject inventory_item;
+    char description[MAX_DESCRIPTION];
+    bool canOpen;
+    bool isOpen;
+    bool canTake;
+    bool isTaken;
+    bool canTalk;
+    NPC* npc;
+} LegacyObject;
+
+typedef struct PassTimes
+{
+    double animate;
+    double hotspots;
+    double draw;
+} PassTimes;
+
+static void PrintTimes(const char* label, PassTimes times, int frames)
+{
+    printf("  %-14s animate %7.3f ms  hotspots %7.3f ms  draw %7.3f ms  per frame\n", label,
+        times.animate * 1000.0 / frames, times.hotspots * 1000.0 / frames, times.draw * 1000.0 / frames);
+}
+
+int main(int argc, char* argv[])
+{
+    int count = (argc > 1) ? atoi(argv[1]) : 100000;
+    int frames = (argc > 2) ? atoi(argv[2]) : 100;
+    if (count < 1) count = 1;
+    if (frames < 1) frames = 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(860, 540, "objects_bench");
+    SetRenderView(860, 540, 1);
+    SetRenderCamera((Camera2D){ .target = { 1000, 1000 }, .zoom = 1.0f });
+
+    LegacyObject* legacy = (LegacyObject*)MemAlloc(count * sizeof(LegacyObject));
+    Rectangle* bounds = (Rectangle*)MemAlloc(count * sizeof(Rectangle));
+    SceneObjects objects = { 0 };
+    LoadSceneObjects(&objects, count);
+
+    // A few open chests and taken keys among the rest
+    for (int i = 0; i < count; ++i)
+    {
+        Vector2 position = { (i % OBJECTS_PER_ROW) * OBJECT_SPACING, (i / OBJECTS_PER_ROW) * OBJECT_SPACING };
+        bool open = (i % 10) == 0;
+        bool taken = (i % 20) == 1;
+
+        legacy[i].world_item = (WorldObject){ .position = position, .size = { 32, 32 }, .scale = { 4, 4 }, .animation = { .total_frames = 4 } };
+        UpdateWorldObjectBounds(&legacy[i].world_item);
+        legacy[i].canOpen = open;
+        legacy[i].isOpen = open;
+        legacy[i].isTaken = taken;
+        TextCopy(legacy[i].description, "Treasure Chest");
+
+        unsigned char flags = (open ? (OBJECT_CAN_OPEN | OBJECT_OPEN) : 0) | (taken ? OBJECT_TAKEN : 0);
+        AddSceneObject(&objects, (Animation){ .total_frames = 4 }, position, (Vector2){ 32, 32 }, (Vector2){ 4, 4 }, flags, "Treasure Chest");
+    }
+
+    PassTimes legacyTimes = { 0 };
+    PassTimes objectTimes = { 0 };
+    int legacyVisible = 0;
+    int objectVisible = 0;
+
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        // Old scene loops, as UpdateForestScene() and DrawForestScene() had them
+        double start = GetTime();
+        for (int i = 0; i < count; ++i)
+        {
+            if (!legacy[i].isTaken && legacy[i].isOpen) PlayAnimationOnce(&legacy[i].world_item.animation, OPEN_ANIMATION_FPS);
+        }
+        legacyTimes.animate += GetTime() - start;
+
+        start = GetTime();
+        for (int i = 0; i < count; ++i) bounds[i] = legacy[i].isTaken ? (Rectangle){ 0 } : legacy[i].world_item.bounds;
+        legacyTimes.hotspots += GetTime() - start;
+
+        start = GetTime();
+        ResetDrawStats();
+        for (int i = 0; i < count; ++i)
+        {
+            if (legacy[i].isTaken || !IsInRenderView(legacy[i].world_item.bounds)) continue;
+
+            WorldObject* item = &legacy[i].world_item;
+            Rectangle source = { item->size.x * item->animation.frame, 0, item->size.x, item->size.y };
+            SubmitSprite(RENDER_WORLD, item->animation.sprite, source, item->bounds, WHITE);
+        }
+        legacyTimes.draw += GetTime() - start;
+        legacyVisible = count - GetDrawStats().culled;
+        DiscardRenderQueue();
+        SetRenderCamera((Camera2D){ .target = { 1000, 1000 }, .zoom = 1.0f });
+
+        // Same work over the component arrays
+        start = GetTime();
+        AnimateSceneObjects(&objects);
+        objectTimes.animate += GetTime() - start;
+
+        start = GetTime();
+        GetSceneObjectHotspots(&objects, bounds);
+        objectTimes.hotspots += GetTime() - start;
+
+        start = GetTime();
+        ResetDrawStats();
+        SubmitSceneObjects(&objects, RENDER_WORLD);
+        objectTimes.draw += GetTime() - start;
+        objectVisible = count - GetDrawStats().culled;
+        DiscardRenderQueue();
+        SetRenderCamera((Camera2D){ .target = { 1000, 1000 }, .zoom = 1.0f });
+    }
+
+    printf("%d objects, %d frames, %d bytes per object before, %d bytes of hot arrays after\n", count, frames, (int)sizeof(LegacyObject),
+        (int)(sizeof(Rectangle) + 1 + sizeof(Vector2) + sizeof(Animation)));
+    PrintTimes("one struct:", legacyTimes, frames);
+    PrintTimes("arrays:", objectTimes, frames);
+    printf("  %d and %d submitted or taken, the rest culled\n", legacyVisible, objectVisible);
+
+    UnloadSceneObjects(&objects);
+    MemFree(bounds);
+    MemFree(legacy);
+    UnloadRenderView();
+    CloseWindow();
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Asset packer: builds data/assets.pak from a list of files, see src/asset_pack.h for the
+*   layout. Entries are stored in list order, so keep tools/pack.lst in order of first use.
+*
+*   Build (from the repository root, no raylib needed):
+*       cc -O2 -Iinclude -Isrc tools/packer.c -o packer
+*
+*   Usage:
+*       packer tools/pack.lst data/assets.pak       Build the pack
+*       packer -b tools/pack.lst data/assets.pak    Compare load time of loose files and pack
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "asset_pack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MAX_PACK_FILES 256
+#define MAX_PATH_LENGTH 256
+
+static char paths[MAX_PACK_FILES][MAX_PATH_LENGTH];
+static int pathCount = 0;
+
+static double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int ReadList(const char* listFile)
+{
+    FILE* file = fopen(listFile, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "packer: cannot open %s\n", listFile);
+        return 0;
+    }
+
+    char line[MAX_PATH_LENGTH];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') continue;
+
+        if (pathCount == MAX_PACK_FILES)
+        {
+            fprintf(stderr, "packer: more than %d files\n", MAX_PACK_FILES);
+            break;
+        }
+
+        // Optional outputs (i.e. the sprite atlas) may not have been generated
+        FILE* check = fopen(line, "rb");
+        if (check == NULL)
+        {
+            fprintf(stderr, "packer: skipping missing %s\n", line);
+            continue;
+        }
+        fclose(check);
+
+        // Duplicates would shadow each other in the directory, keep the first use
+        int duplicate = 0;
+        for (int i = 0; i < pathCount; ++i) duplicate |= (strcmp(paths[i], line) == 0);
+        if (!duplicate) strcpy(paths[pathCount++], line);
+    }
+
+    fclose(file);
+    return pathCount;
+}
+
+static unsigned char* ReadWholeFile(const char* fileName, long* size)
+{
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char* data = malloc(*size > 0 ? *size : 1);
+    if (fread(data, 1, *size, file) != (size_t)*size)
+    {
+        free(data);
+        data = NULL;
+    }
+
+    fclose(file);
+    return data;
+}
+
+static unsigned int Align(unsigned int value)
+{
+    return (value + PACK_DATA_ALIGNMENT - 1) & ~(unsigned int)(PACK_DATA_ALIGNMENT - 1);
+}
+
+static int BuildPack(const char* outputFile)
+{
+    PackHeader header = { 0 };
+    memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.entryCount = pathCount;
+    header.slotCount = 1;
+    while (header.slotCount < 2 * (unsigned int)pathCount) header.slotCount <<= 1;
+
+    PackEntry* entries = calloc(pathCount, sizeof(PackEntry));
+    unsigned int* slots = calloc(header.slotCount, sizeof(unsigned int));
+
+    unsigned int offset = sizeof(PackHeader) + pathCount * sizeof(PackEntry) + header.slotCount * sizeof(unsigned int);
+    for (int i = 0; i < pathCount; ++i)
+    {
+        entries[i].nameOffset = offset;
+        offset += (unsigned int)strlen(paths[i]) + 1;
+    }
+
+    unsigned char** data = calloc(pathCount, sizeof(unsigned char*));
+    for (int i = 0; i < pathCount; ++i)
+    {
+        long size = 0;
+        data[i] = ReadWholeFile(paths[i], &size);
+        if (data[i] == NULL)
+        {
+            fprintf(stderr, "packer: cannot read %s\n", paths[i]);
+            return 1;
+        }
+
+        offset = Align(offset);
+        entries[i].hash = HashPackPath(paths[i]);
+        entries[i].dataOffset = offset;
+        entries[i].dataSize = (unsigned int)size;
+        offset += (unsigned int)size;
+
+        unsigned int mask = header.slotCount - 1;
+        unsigned int slot = entries[i].hash & mask;
+        while (slots[slot] != 0) slot = (slot + 1) & mask;
+        slots[slot] = i + 1;
+    }
+
+    FILE* file = fopen(outputFile, "wb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "packer: cannot write %s\n", outputFile);
+        return 1;
+    }
+
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(entries, sizeof(PackEntry), pathCount, file);
+    fwrite(slots, sizeof(unsigned int), header.slotCount, file);
+    for (int i = 0; i < pathCount; ++i) fwrite(paths[i], 1, strlen(paths[i]) + 1, file);
+
+    static const unsigned char padding[PACK_DATA_ALIGNMENT] = { 0 };
+    for (int i = 0; i < pathCount; ++i)
+    {
+        long position = ftell(file);
+        fwrite(padding, 1, entries[i].dataOffset - position, file);
+        fwrite(data[i], 1, entries[i].dataSize, file);
+        free(data[i]);
+    }
+
+    printf("packer: %d files, %ld bytes -> %s\n", pathCount, ftell(file), outputFile);
+    fclose(file);
+
+    free(data);
+    free(slots);
+    free(entries);
+    return 0;
+}
+
+static int BenchPack(const char* packFile)
+{
+    // Loose files: one open/seek/read/close per asset, like raylib's LoadFileData()
+    double start = Now();
+    unsigned long looseBytes = 0;
+    unsigned int looseCheck = 0;
+    for (int i = 0; i < pathCount; ++i)
+    {
+        long size = 0;
+        unsigned char* data = ReadWholeFile(paths[i], &size);
+        if (data == NULL) continue;
+        looseBytes += size;
+        for (long b = 0; b < size; b += 4096) looseCheck += data[b];
+        free(data);
+    }
+    double looseTime = Now() - start;
+
+    // Pack: one open and mmap, then a hashed lookup and the pages of each asset
+    start = Now();
+    int fd = open(packFile, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        fprintf(stderr, "packer: cannot open %s\n", packFile);
+        return 1;
+    }
+    unsigned char* pack = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pack == MAP_FAILED) return 1;
+
+    const PackHeader* header = (const PackHeader*)pack;
+    const PackEntry* entries = (const PackEntry*)(pack + sizeof(PackHeader));
+    const unsigned int* slots = (const unsigned int*)(entries + header->entryCount);
+
+    unsigned long packBytes = 0;
+    unsigned int packCheck = 0;
+    for (int i = 0; i < pathCount; ++i)
+    {
+        unsigned int hash = HashPackPath(paths[i]);
+        for (unsigned int p = 0; p < header->slotCount; ++p)
+        {
+            unsigned int slot = slots[(hash + p) & (header->slotCount - 1)];
+            if (slot == 0) break;
+
+            const PackEntry* entry = &entries[slot - 1];
+            if (entry->hash == hash && strcmp((const char*)pack + entry->nameOffset, paths[i]) == 0)
+            {
+                const unsigned char* data = pack + entry->dataOffset;
+                packBytes += entry->dataSize;
+                for (unsigned int b = 0; b < entry->dataSize; b += 4096) packCheck += data[b];
+                break;
+            }
+        }
+    }
+    double packTime = Now() - start;
+    munmap(pack, info.st_size);
+
+    printf("loose files: %d files, %lu bytes, %.3f ms\n", pathCount, looseBytes, looseTime * 1000.0);
+    printf("asset pack:  %d files, %lu bytes, %.3f ms\n", pathCount, packBytes, packTime * 1000.0);
+    if (looseCheck != packCheck) printf("WARNING: contents differ between loose files and pack\n");
+    printf("NOTE: drop the page cache first (echo 3 > /proc/sys/vm/drop_caches) to compare cold starts\n");
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    int bench = (argc == 4 && strcmp(argv[1], "-b") == 0);
+
+    if (argc != 3 && !bench)
+    {
+        fprintf(stderr, "usage: packer [-b] <list file> <pack file>\n");
+        return 1;
+    }
+
+    if (ReadList(argv[argc - 2]) == 0) return 1;
+
+    return bench ? BenchPack(argv[argc - 1]) : BuildPack(argv[argc - 1]);
+}
@@ -0,0 +1,131 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Pixel scale benchmark: draws the forest layers and a row of props and actors at their 4x
+*   game scale through the render queue, once per pixel scale, and prints frame time and fill.
+*   Vsync is off and the window is hidden. Fill cost only dominates on software GL, run it as
+*   LIBGL_ALWAYS_SOFTWARE=1 to see what low end machines without a GPU driver get.
+*
+*   Every layer is drawn every frame by default, as animated layers would be. Pass "flat" to
+*   flatten them first like the game does, the upscale is then most of what is left to save.
+*
+*   Build (from the repository root, links raylib):
+*       cc -O2 -Iinclude -Isrc tools/pixel_bench.c src/render.c src/background.c src/texture_cache.c \
+*          src/hit_mask.c src/asset_prefetch.c src/asset_pack.c src/text.c src/text_cache.c -lraylib -lpthread -lm -o pixel_bench
+*
+*   Usage:
+*       LIBGL_ALWAYS_SOFTWARE=1 pixel_bench [frames] [flat]
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "render.h"
+#include "background.h"
+#include "texture_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VIEW_WIDTH 860
+#define VIEW_HEIGHT 540
+#define BENCH_LAYERS 6
+#define BENCH_SPRITES 6
+
+static const char* layerFiles[BENCH_LAYERS] = {
+    "data/bg.png", "data/trees3.png", "data/trees2.png", "data/trees1.png", "data/bushes.png", "data/grass.png"
+};
+
+static const char* spriteFiles[BENCH_SPRITES] = {
+    "data/Chest.png", "data/Key.png", "data/Woodcutter.png", "data/GraveRobber.png", "data/Chest.png", "data/Woodcutter.png"
+};
+
+static const int spriteSizes[BENCH_SPRITES] = { 32, 8, 48, 48, 32, 48 };
+
+static Sprite sprites[BENCH_SPRITES] = { 0 };
+
+static void SubmitScene(Background* background)
+{
+    SetRenderCamera((Camera2D){ .zoom = 1.0f });
+
+    DrawBackground(background);
+
+    for (int i = 0; i < BENCH_SPRITES; ++i)
+    {
+        float size = (float)spriteSizes[i];
+        Rectangle source = { 0, 0, size, size };
+        Rectangle dest = { 40.0f + i * 130.0f, 300.0f, size * 4, size * 4 };
+        SubmitSprite((i < 3) ? RENDER_WORLD : RENDER_ACTORS, sprites[i], source, dest, WHITE);
+    }
+
+    SubmitPanel(RENDER_UI_PANELS, 0, 0, VIEW_WIDTH, 80, DARKGRAY);
+}
+
+int main(int argc, char* argv[])
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : 300;
+    bool flat = (argc > 2) && (strcmp(argv[2], "flat") == 0);
+    if (frames < 1) frames = 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(VIEW_WIDTH, VIEW_HEIGHT, "pixel_bench");
+    SetTargetFPS(0);
+
+    BackgroundLayer layers[BENCH_LAYERS];
+    for (int i = 0; i < BENCH_LAYERS; ++i)
+    {
+        layers[i] = (BackgroundLayer){ layerFiles[i], { 0, 0 }, 0.5f, flat ? LAYER_STATIC : LAYER_ANIMATED };
+    }
+
+    Background background = { 0 };
+    LoadBackground(&background, layers, BENCH_LAYERS);
+    for (int i = 0; i < BENCH_SPRITES; ++i) sprites[i] = AcquireSprite(spriteFiles[i]);
+
+    printf("%s layers, %d frames at %dx%d\n", flat ? "flattened" : "separate", frames, VIEW_WIDTH, VIEW_HEIGHT);
+
+    const int scales[] = { 1, 2, 4 };
+    double baseMs = 0.0;
+
+    for (int s = 0; s < (int)(sizeof(scales) / sizeof(scales[0])); ++s)
+    {
+        SetRenderView(VIEW_WIDTH, VIEW_HEIGHT, scales[s]);
+
+        double pixels = 0.0;
+        double start = 0.0;
+
+        // First frames upload textures and warm the driver up, not timed
+        for (int i = -10; i < frames; ++i)
+        {
+            if (i == 0) start = GetTime();
+
+            UpdateTextureCache();
+            ResetDrawStats();
+            SubmitScene(&background);
+
+            BeginDrawing();
+            ClearBackground(RAYWHITE);
+            FlushRenderQueue();
+            EndDrawing();
+
+            if (i >= 0) pixels += GetDrawStats().pixels;
+        }
+
+        double ms = (GetTime() - start) * 1000.0 / frames;
+        if (s == 0) baseMs = ms;
+
+        printf("  pixel scale %d: %8.3f ms/frame  %6.2f screens filled  (%.2fx faster)\n", scales[s], ms,
+            pixels / frames / (VIEW_WIDTH * VIEW_HEIGHT), (ms > 0.0) ? baseMs / ms : 0.0);
+    }
+
+    for (int i = 0; i < BENCH_SPRITES; ++i) ReleaseSprite(sprites[i]);
+    UnloadBackground(&background);
+    UnloadRenderView();
+    UnloadTextureCache();
+    CloseWindow();
+
+    return 0;
+}
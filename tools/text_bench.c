@@ -0,0 +1,147 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Text cache benchmark: draws a long dialogue panel glyph by glyph with DrawGameText() and
+*   then again from the text cache, one quad per line, and prints the frame time of each.
+*   Vsync is off and the window is hidden, so the numbers are CPU plus GPU submit cost.
+*
+*   Build (from the repository root, links raylib):
+*       cc -O2 -Iinclude -Isrc tools/text_bench.c src/text.c src/text_cache.c -lraylib -lm -o text_bench
+*
+*   Usage:
+*       text_bench [frames] [lines]
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "text.h"
+#include "text_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_BENCH_LINES 64
+#define FONT_SIZE 20.0f
+#define FONT_SPACING 1.0f
+#define LINE_HEIGHT 22
+
+static const char* dialogue[] = {
+    "The old woodcutter leans on his axe and looks you over.",
+    "You are not from the village, are you? Nobody from there comes this deep.",
+    "They say the treasure lies beneath the ruins to the north.",
+    "Many have gone looking. None have come back with more than a cough.",
+    "If you mean to try, you will need a key, and a steady hand.",
+    "The grave robber by the gate might sell you one, for the right price.",
+    "Mind the butterflies. They lead the careless into the bog.",
+    "Now off with you, I have wood to cut before the sun goes down.",
+};
+
+static char lines[MAX_BENCH_LINES][128];
+static int lineCount = 0;
+
+static void DrawDirect(void)
+{
+    for (int i = 0; i < lineCount; i++)
+    {
+        DrawGameText(lines[i], (Vector2){ 20, 20 + i*LINE_HEIGHT }, FONT_SIZE, FONT_SPACING, RAYWHITE);
+    }
+}
+
+// Returns the number of lines that were still pending and drawn glyph by glyph
+static int DrawCached(void)
+{
+    int missed = 0;
+
+    for (int i = 0; i < lineCount; i++)
+    {
+        Vector2 position = { 20, 20 + i*LINE_HEIGHT };
+        Texture2D texture;
+        Rectangle source;
+        Vector2 offset;
+
+        if (FindCachedText(lines[i], FONT_SIZE, FONT_SPACING, RAYWHITE, &texture, &source, &offset))
+        {
+            Rectangle dest = { position.x + offset.x, position.y + offset.y, source.width, -source.height };
+            DrawTexturePro(texture, source, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+        }
+        else
+        {
+            DrawGameText(lines[i], position, FONT_SIZE, FONT_SPACING, RAYWHITE);
+            missed++;
+        }
+    }
+
+    return missed;
+}
+
+static double TimeFrames(int frames, bool cached)
+{
+    double start = GetTime();
+
+    for (int i = 0; i < frames; i++)
+    {
+        BeginDrawing();
+        ClearBackground(BLACK);
+        DrawRectangle(10, 10, 780, lineCount*LINE_HEIGHT + 20, Fade(DARKBROWN, 0.9f));
+        if (cached) DrawCached();
+        else DrawDirect();
+        EndDrawing();
+    }
+
+    return (GetTime() - start)*1000.0/frames;
+}
+
+int main(int argc, char* argv[])
+{
+    int frames = (argc > 1)? atoi(argv[1]) : 600;
+    lineCount = (argc > 2)? atoi(argv[2]) : 40;
+    if (frames < 1) frames = 1;
+    if (lineCount < 1) lineCount = 1;
+    if (lineCount > MAX_BENCH_LINES) lineCount = MAX_BENCH_LINES;
+
+    int dialogueLines = sizeof(dialogue)/sizeof(dialogue[0]);
+    for (int i = 0; i < lineCount; i++)
+    {
+        snprintf(lines[i], sizeof(lines[i]), "%02d  %s", i + 1, dialogue[i%dialogueLines]);
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(800, 20 + lineCount*LINE_HEIGHT + 40, "text_bench");
+    SetTargetFPS(0);
+
+    LoadGameFont("data/pixantiqua.ttf");
+    LoadTextCache();
+    SetTextCacheGroup(TEXT_GROUP_DIALOGUE);
+
+    // Warm up: let the font add every glyph and the cache render every line
+    for (int i = 0; i < 8; i++)
+    {
+        UpdateGameFont();
+        UpdateTextCache();
+        BeginDrawing();
+        ClearBackground(BLACK);
+        DrawDirect();
+        int missed = DrawCached();
+        EndDrawing();
+        if ((i > 0) && (missed == 0)) break;
+    }
+
+    double directMs = TimeFrames(frames, false);
+    double cachedMs = TimeFrames(frames, true);
+    TextCacheStats stats = GetTextCacheStats();
+
+    printf("dialogue panel: %d lines, %d frames\n", lineCount, frames);
+    printf("  glyph by glyph: %8.3f ms/frame\n", directMs);
+    printf("  text cache:     %8.3f ms/frame  (%d strings cached, %d misses)\n", cachedMs, stats.cachedTexts, stats.misses);
+    printf("  speedup:        %8.2fx\n", (cachedMs > 0.0)? directMs/cachedMs : 0.0);
+
+    UnloadTextCache();
+    UnloadGameFont();
+    CloseWindow();
+
+    return 0;
+}
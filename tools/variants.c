@@ -0,0 +1,85 @@
+/**********************************************************************************************
+*
+*   Adventure Game Jam 2022 Entry - The Lost Treasure
+*
+*   Resolution variants: writes downscaled copies of full HD art next to the originals, i.e.
+*   data/bg.png -> data/1x/bg.png at half size. At startup the game picks the variant that
+*   matches the window (see SetTextureVariant()) and falls back to the original per file.
+*   The scale comes from the variant name, the same way the game reads it (GetVariantScale()).
+*
+*   Sprites packed by tools/atlas.c are always drawn from the atlas, leave them out.
+*
+*   Build (from the repository root, links raylib, no window is opened):
+*       cc -O2 -Iinclude -Isrc tools/variants.c -lraylib -lm -o variants
+*
+*   Usage:
+*       variants 1x data/bg.png data/trees3.png data/trees2.png data/trees1.png \
+*                data/bushes.png data/grass.png
+*
+*   Copyright (c) 2022 David Athay
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "texture_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: variants <variant> <image.png>...\n");
+        return 1;
+    }
+
+    const char* variant = argv[1];
+    float scale = GetVariantScale(variant);
+    if (scale <= 0.0f || scale >= 1.0f)
+    {
+        fprintf(stderr, "variants: %s is not a variant below %ix, i.e. 1x\n", variant, SOURCE_ART_SCALE);
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    long totalBefore = 0;
+    long totalAfter = 0;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        Image image = LoadImage(argv[i]);
+        if (image.data == NULL)
+        {
+            fprintf(stderr, "variants: cannot load %s\n", argv[i]);
+            return 1;
+        }
+
+        int before = GetPixelDataSize(image.width, image.height, image.format);
+        ImageResize(&image, (int)(image.width * scale), (int)(image.height * scale));
+        int after = GetPixelDataSize(image.width, image.height, image.format);
+
+        char directory[256];
+        char output[512];
+        snprintf(directory, sizeof(directory), "%s/%s", GetDirectoryPath(argv[i]), variant);
+        snprintf(output, sizeof(output), "%s/%s", directory, GetFileName(argv[i]));
+        mkdir(directory, 0755);
+
+        if (!ExportImage(image, output))
+        {
+            fprintf(stderr, "variants: cannot write %s\n", output);
+            return 1;
+        }
+
+        printf("%s -> %s (%dx%d, %d KB -> %d KB of texture memory)\n", argv[i], output, image.width, image.height, before / 1024, after / 1024);
+        totalBefore += before;
+        totalAfter += after;
+
+        UnloadImage(image);
+    }
+
+    printf("variants: %.2f MB -> %.2f MB\n", totalBefore / (1024.0 * 1024.0), totalAfter / (1024.0 * 1024.0));
+    return 0;
+}